@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+#include "ImageManager.h"
+#include "SpriteStore.h"
+#include "ParticleEmitter.h"
+#include "TileMap.h"
+#include "SpriteHierarchy.h"
+
+// 无窗口动画基准：在软件渲染器上反复 Update + Draw，输出平均帧耗时
+// 用法：anim_bench [帧数] [每帧精灵数] [精灵图路径] [manager|store|particles|tilemap|attach]
+//   manager：逐个调用 AnimationManager_Draw（按字符串 key 查找）
+//   store：精灵放进 SpriteStore，每帧一次 Update + DrawAll
+//   particles：精灵数为存活粒子数，一个 ParticleEmitter 持续发射，每帧一次 Update + Draw
+//   tilemap：精灵数为地图格数（正方形地图，图块集即精灵图各帧），摄像机每帧平移并改写一格
+//   attach：同 store，但实体每 8 个串成一条挂接链（根移动，子节点挂在父帧 "tip" 挂点上），每帧多一次 SpriteHierarchy_Update
+// 也是 PGO 训练负载（见 CMakeLists.txt 中的 pgo_train 目标）
+
+#define BENCH_WIDTH  1920
+#define BENCH_HEIGHT 1080
+
+int main(int argc, char* argv[]) {
+    int frames = argc > 1 ? atoi(argv[1]) : 600;
+    int sprites = argc > 2 ? atoi(argv[2]) : 500;
+    const char* sheet_path = argc > 3 ? argv[3] : "./assets/image/player/player1.png";
+    const char* mode = argc > 4 ? argv[4] : "manager";
+    bool use_store = strcmp(mode, "store") == 0;
+    bool use_particles = strcmp(mode, "particles") == 0;
+    bool use_tilemap = strcmp(mode, "tilemap") == 0;
+    bool use_attach = strcmp(mode, "attach") == 0;
+    if (frames <= 0 || sprites <= 0 || (!use_store && !use_particles && !use_tilemap && !use_attach && strcmp(mode, "manager") != 0)) {
+        fprintf(stderr, "Usage: %s [frames] [sprites] [sheet_path] [manager|store|particles|tilemap|attach]\n", argv[0]);
+        return 1;
+    }
+
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        fprintf(stderr, "SDL Error: %s (in SDL_Init)\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_WIDTH, BENCH_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (!renderer) {
+        fprintf(stderr, "SDL Error: %s (in SDL_CreateSoftwareRenderer)\n", SDL_GetError());
+        if (surface) SDL_FreeSurface(surface);
+        SDL_Quit();
+        return 1;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    ImageManager* img_manager = ImageManager_GetInstance(renderer);
+    AnimationManager* anim_manager = AnimationManager_Create(img_manager, renderer);
+    if (!ImageManager_LoadTexture(img_manager, "bench_sprites", sheet_path)) {
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(surface);
+        SDL_Quit();
+        return 1;
+    }
+
+    Animation* anim = AnimationManager_LoadAnimation(anim_manager, "bench", "bench_sprites", 20, 8);
+    int walk_frames[] = {6, 7, 8, 9, 10, 11};
+    AnimationManager_AddClip(anim, "walk", walk_frames, 6, 0.1f, true, false);
+    AnimationManager_Play(anim_manager, "bench", "walk");
+
+    SpriteStore* store = NULL;
+    if (use_store || use_attach) {
+        store = SpriteStore_Create(anim_manager, sprites);
+        for (int s = 0; store && s < sprites; s++) {
+            SpriteEntity e = SpriteStore_CreateEntity(store, anim, (s * 37) % BENCH_WIDTH, (s * 53) % BENCH_HEIGHT);
+            SpriteStore_SetVelocity(store, e, (float)(s % 7) - 3.0f, (float)(s % 5) - 2.0f);
+            SpriteStore_SetTransform(store, e, 2.0f, 0.0f, (s & 1) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+            SpriteStore_SetLayer(store, e, s % 4);
+            SpriteStore_Play(store, e, "walk");
+        }
+    }
+
+    SpriteHierarchy* hierarchy = NULL;
+    if (use_attach && store) {
+        // 挂点随帧左右摆动，子节点每帧都要重算
+        int tip = AnimationManager_AddAnchor(anim, "tip");
+        for (int i = 0; i < anim->total_frames; i++) {
+            AnimationManager_SetAnchor(anim, tip, i, anim->frames[i].rect.w * (0.5f + 0.05f * (i % 6)), 0.0f);
+        }
+        hierarchy = SpriteHierarchy_Create(store, sprites);
+        for (int s = 1; hierarchy && s < store->count; s++) {
+            if (s % 8 == 0) continue;
+            SpriteHierarchy_Attach(hierarchy, store->entities[s], store->entities[s - 1], "tip", 0.0f, 0.0f);
+            SpriteHierarchy_SetLocal(hierarchy, store->entities[s], 0.0f, 0.0f, 0.9f, 0.2f, SDL_FLIP_NONE);
+        }
+    }
+
+    ParticleEmitter* emitter = NULL;
+    if (use_particles) {
+        // 寿命 1~2 秒，按平均寿命设置发射速率，存活数稳定在 sprites 附近
+        emitter = ParticleEmitter_Create(anim_manager, anim, "walk", sprites);
+        ParticleEmitter_SetOrigin(emitter, BENCH_WIDTH / 2.0f, BENCH_HEIGHT / 2.0f);
+        ParticleEmitter_SetEmission(emitter, 0.0f, 2.0f * (float)M_PI, 100.0f, 600.0f, 1.0f, 2.0f);
+        ParticleEmitter_SetGravity(emitter, 0.0f, 300.0f);
+        ParticleEmitter_SetRate(emitter, sprites / 1.5f);
+        ParticleEmitter_SetAppearance(emitter, 0.5f, true);
+        ParticleEmitter_Emit(emitter, sprites);
+    }
+
+    TileMap* map = NULL;
+    int map_side = 1;
+    while ((map_side + 1) * (map_side + 1) <= sprites) map_side++;
+    if (use_tilemap) {
+        map = TileMap_Create(anim_manager, anim, map_side, map_side);
+        for (int ty = 0; map && ty < map_side; ty++) {
+            for (int tx = 0; tx < map_side; tx++) {
+                TileMap_SetTile(map, tx, ty, (Uint16)((tx * 7 + ty * 13) % anim->total_frames));
+            }
+        }
+    }
+
+    Uint64 perf_freq = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int f = 0; f < frames; f++) {
+        AnimationManager_Update(anim_manager, 1.0f / 60.0f);
+        SpriteStore_Update(store, 1.0f / 60.0f);
+        ParticleEmitter_Update(emitter, 1.0f / 60.0f);
+        SpriteHierarchy_Update(hierarchy);
+        SDL_RenderClear(renderer);
+        RenderStats_BeginFrame(RenderStats_GetInstance(), renderer);
+        if (store) {
+            SpriteStore_DrawAll(store);
+        } else if (emitter) {
+            ParticleEmitter_Draw(emitter);
+        } else if (map) {
+            // 每帧改写一格，只重建一个区块
+            TileMap_SetTile(map, f % map_side, (f / map_side) % map_side, (Uint16)(f % anim->total_frames));
+            SDL_Rect view = { (f * 4) % (map_side * map->tile_w), (f * 2) % (map_side * map->tile_h), BENCH_WIDTH, BENCH_HEIGHT };
+            TileMap_Draw(map, &view);
+        } else {
+            for (int s = 0; s < sprites; s++) {
+                AnimationManager_Draw(
+                    anim_manager, "bench",
+                    (s * 37) % BENCH_WIDTH, (s * 53) % BENCH_HEIGHT,
+                    0, 0, 2.0f, 0.0f,
+                    (s & 1) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE
+                );
+            }
+        }
+        SDL_RenderPresent(renderer);
+        RenderStats_EndFrame(RenderStats_GetInstance());
+    }
+    double total_ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / perf_freq;
+
+    printf("anim_bench: %d frames, %d sprites (%s), %.3f ms/frame\n",
+           frames, sprites, mode, total_ms / frames);
+
+    RenderStatsSummary summary;
+    if (RenderStats_GetSummary(RenderStats_GetInstance(), &summary)) {
+        printf("anim_bench: draw_calls avg %u, sprites avg %u, texture_switches avg %u, overdraw avg %.2f\n",
+               summary.avg.draw_calls, summary.avg.sprites, summary.avg.texture_switches, summary.avg.overdraw);
+    }
+
+    SpriteHierarchy_Destroy(hierarchy);
+    SpriteStore_Destroy(store);
+    ParticleEmitter_Destroy(emitter);
+    TileMap_Destroy(map);
+    AnimationManager_Destroy(anim_manager);
+    ImageManager_DestroyInstance();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    SDL_Quit();
+    return 0;
+}
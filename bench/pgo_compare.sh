@@ -0,0 +1,36 @@
+#!/bin/sh
+# 对比 Release(-O3 -march=native) / RelWithLTO / Release+PGO 的 anim_bench 帧耗时
+# 用法：在仓库根目录执行 sh bench/pgo_compare.sh [帧数] [每帧精灵数]
+set -e
+
+FRAMES=${1:-600}
+SPRITES=${2:-500}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${ROOT}/build-compare
+JOBS=$(nproc 2>/dev/null || echo 4)
+
+build() { # <目录> <cmake 参数...>
+    dir=$1; shift
+    cmake -S "${ROOT}" -B "${OUT}/${dir}" "$@" > /dev/null
+    cmake --build "${OUT}/${dir}" --target anim_bench -j"${JOBS}" > /dev/null
+}
+
+run() { # <目录>，输出 ms/frame
+    (cd "${ROOT}" && "${OUT}/$1/anim_bench" "${FRAMES}" "${SPRITES}") | sed -n 's/.*, \([0-9.]*\) ms\/frame/\1/p'
+}
+
+build release -DCMAKE_BUILD_TYPE=Release
+build lto -DCMAKE_BUILD_TYPE=RelWithLTO
+build pgo -DCMAKE_BUILD_TYPE=Release -DPGO_STAGE=GENERATE
+cmake --build "${OUT}/pgo" --target pgo_train > /dev/null
+build pgo -DCMAKE_BUILD_TYPE=Release -DPGO_STAGE=USE
+
+BASE=$(run release)
+LTO=$(run lto)
+PGO=$(run pgo)
+
+speedup() { awk -v a="$1" -v b="$2" 'BEGIN { printf "%.2fx", a / b }'; }
+
+echo "Release    : ${BASE} ms/frame"
+echo "RelWithLTO : ${LTO} ms/frame (speedup $(speedup "${BASE}" "${LTO}"))"
+echo "Release+PGO: ${PGO} ms/frame (speedup $(speedup "${BASE}" "${PGO}"))"
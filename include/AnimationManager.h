@@ -7,16 +7,34 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "RenderStats.h"
+
+// Alpha 位掩码阈值（alpha >= 阈值视为不透明）
+#define ALPHA_MASK_THRESHOLD 128
+
+// 渲染器未报告纹理尺寸上限时（如软件渲染器）使用的分块上限
+#define ANIMATION_TILE_MAX_SIZE 2048
 
 // 前置声明（兼容 ImageManager）
 struct ImageManager;
 typedef struct ImageManager ImageManager;
+struct SpritePalette;
+struct PaletteManager;
 
 // 单个动画帧信息
 typedef struct AnimationFrame {
     SDL_Rect rect;  // 帧在精灵图中的矩形区域
+    int tile;       // 帧所在分块下标
+    SDL_Rect src;   // 帧在分块纹理中的矩形区域
 } AnimationFrame;
 
+// 精灵图分块（整图模式只有一块，即 ImageManager 中的纹理）
+typedef struct AnimationTile {
+    SDL_Rect area;          // 分块在精灵图中的区域
+    SDL_Texture* texture;   // 分块纹理（按需上传前为 NULL）
+    bool owned;             // 纹理是否由动画负责释放
+} AnimationTile;
+
 // 动画序列（绑定索引序列）
 typedef struct AnimationClip {
     char* name;             // 动画名称（如 "idle" "walk"）
@@ -27,16 +45,39 @@ typedef struct AnimationClip {
     bool reverse;           // 是否反向播放
 } AnimationClip;
 
+// 挂点（如手部位置）：每帧一个帧内坐标，供 SpriteHierarchy 挂接子精灵
+typedef struct AnimationAnchor {
+    char* name;
+    SDL_FPoint* points;     // total_frames 个（像素，相对帧左上角；默认为帧中心）
+} AnimationAnchor;
+
 // 动画对象（对应一张精灵图）
 typedef struct Animation {
     char* texture_key;      // 关联的 ImageManager 纹理key
-    SDL_Texture* texture;   // 精灵图纹理
+    SDL_Texture* texture;   // 精灵图纹理（分块模式下为 NULL）
     int rows;               // 精灵图行数
     int cols;               // 精灵图列数
     int total_frames;       // 总帧数（rows*cols）
     AnimationFrame* frames; // 所有帧的矩形缓存
+    // 分块：每块为一行帧中放得下渲染器纹理上限的若干列，序列首次播放时才上传
+    AnimationTile* tiles;
+    int tile_count;
+    int tiles_loaded;       // 已上传分块数
+    char* sheet_path;       // 分块模式的源文件路径：上传时重新解码，传完即释放像素（解码失败后置 NULL）
+    // 索引模式：不创建分块纹理，绘制时由 PaletteManager 按调色板解析颜色
+    SDL_Surface* index_sheet;   // 8 位索引像素（ImageManager 共享，不负责释放）
+    struct SpritePalette* default_palette; // 精灵图自带调色板
+    struct SpritePalette* palette;         // AnimationManager_Draw 使用的调色板（NULL 为自带）
+    int transparent_index;      // 透明色索引（-1 表示无）
+    // 每帧 1-bit Alpha 掩码（按行打包为 64 位字，行尾补 0）
+    Uint64* alpha_masks;    // total_frames * mask_words，帧 i 从 i * mask_words 开始
+    Uint64* alpha_masks_flipped; // 水平翻转后的掩码，布局相同
+    int mask_stride;        // 每行字数（ceil(帧宽 / 64)）
+    int mask_words;         // 每帧字数（mask_stride * 帧高）
     AnimationClip** clips;  // 动画序列数组
     int clip_count;         // 动画序列数量
+    AnimationAnchor* anchors; // 挂点数组
+    int anchor_count;
     // 播放状态
     char* current_clip;     // 当前播放的动画序列名称
     float elapsed_time;     // 已播放时间
@@ -50,14 +91,20 @@ typedef struct AnimationManager {
     Animation** animations; // 动画对象数组
     int animation_count;    // 动画对象数量
     ImageManager* img_manager; // 关联的图像管理器
-    SDL_Renderer* renderer; // 渲染器
+    SDL_Renderer* renderer; // 渲染器（渲染线程模式下为 NULL，纹理一律由渲染线程创建）
+    RenderStats* stats;     // 渲染统计（绘制时累计）
+    struct RenderQueue* queue; // 非 NULL 时绘制只录制命令，分块由渲染线程上传
+    struct PaletteManager* palettes; // 调色板与展开纹理缓存（索引精灵图）
 } AnimationManager;
 
 // ========== 核心接口 ==========
-// 1. 创建动画管理器（关联 ImageManager 和渲染器）
+// 1. 创建动画管理器（关联 ImageManager 和渲染器；使用渲染线程时 renderer 传 NULL 再 RenderQueue_Attach）
 AnimationManager* AnimationManager_Create(ImageManager* img_manager, SDL_Renderer* renderer);
 
 // 2. 加载精灵图并创建动画对象（按行列分割）
+//    texture_key 用 ImageManager_LoadTexture 加载：整图一个纹理
+//    texture_key 用 ImageManager_RegisterSheet 注册：按渲染器上限分块，播放时按需上传
+//    texture_key 用 ImageManager_LoadIndexed 加载：索引模式，颜色变体只需调色板
 Animation* AnimationManager_LoadAnimation(
     AnimationManager* manager,
     const char* anim_key,       // 动画唯一标识
@@ -77,6 +124,11 @@ bool AnimationManager_AddClip(
     bool reverse                // 是否反向播放
 );
 
+// 为动画添加挂点（已存在则返回原下标）并按帧设置位置；FindAnchor 无则返回 -1
+int AnimationManager_AddAnchor(Animation* anim, const char* anchor_name);
+bool AnimationManager_SetAnchor(Animation* anim, int anchor, int frame_idx, float x, float y);
+int AnimationManager_FindAnchor(const Animation* anim, const char* anchor_name);
+
 // 4. 更新动画（需在主循环中调用，传入deltaTime）
 void AnimationManager_Update(AnimationManager* manager, float dt);
 
@@ -91,14 +143,33 @@ void AnimationManager_Draw(
     SDL_RendererFlip flip       // 翻转模式
 );
 
-// 6. 控制动画播放
+// 6. 控制动画播放（Play 会先上传序列用到的分块；使用渲染线程时推迟到渲染线程）
+bool AnimationManager_PrepareClip(AnimationManager* manager, Animation* anim, const AnimationClip* clip);
+// 上传分块（须在渲染器所在线程调用）：每次调用解码一次源图片，上传后立即释放像素
+bool AnimationManager_UploadTile(AnimationManager* manager, Animation* anim, int tile_idx);
+bool AnimationManager_UploadTiles(AnimationManager* manager, Animation* anim, const int* tile_indices, int count);
 void AnimationManager_Play(AnimationManager* manager, const char* anim_key, const char* clip_name);
 void AnimationManager_Pause(AnimationManager* manager, const char* anim_key);
 void AnimationManager_Resume(AnimationManager* manager, const char* anim_key);
 void AnimationManager_SetSpeed(AnimationManager* manager, const char* anim_key, float speed);
+void AnimationManager_SetPalette(AnimationManager* manager, const char* anim_key, struct SpritePalette* palette); // 仅索引模式
+
+// 7. 像素级命中/碰撞（基于 Alpha 位掩码，坐标为帧内像素，旋转不参与）
+// 帧内点 (local_x, local_y) 是否不透明（flip 为绘制时的翻转模式）
+bool AnimationManager_FrameHitTest(const Animation* anim, int frame_idx, int local_x, int local_y, SDL_RendererFlip flip);
+// 帧 b 的左上角相对帧 a 左上角偏移 (dx, dy) 时，两帧是否有不透明像素重叠
+bool AnimationManager_FrameOverlap(
+    const Animation* a, int frame_a, SDL_RendererFlip flip_a,
+    const Animation* b, int frame_b, SDL_RendererFlip flip_b,
+    int dx, int dy
+);
 
-// 7. 销毁动画对象/管理器
+// 8. 销毁动画对象/管理器
+//    使用渲染线程时 DestroyAnimation 立即移除动画，释放推迟到渲染线程执行完已录制的帧之后
+//    Destroy 须在 RenderQueue_Destroy 之后调用
 void AnimationManager_DestroyAnimation(AnimationManager* manager, const char* anim_key);
 void AnimationManager_Destroy(AnimationManager* manager);
+// 释放全部已上传的分块纹理和调色板展开纹理（渲染线程退出前在渲染线程调用）
+void AnimationManager_ReleaseTextures(AnimationManager* manager);
 
 #endif // ANIMATION_MANAGER_H
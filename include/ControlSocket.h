@@ -0,0 +1,82 @@
+#ifndef CONTROL_SOCKET_H
+#define CONTROL_SOCKET_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "ImageManager.h"
+#include "SpriteStore.h"
+#include "RenderStats.h"
+#include "FrameRecorder.h"
+
+// 本地控制通道（Unix domain socket，SOCK_STREAM，本机字节序）
+// 每条消息：ControlHeader + payload
+//   PLAY_CLIP    : Uint32 entity + 序列名（其余字节，无需 '\0'）
+//   SET_SPEED    : Uint32 entity + float speed
+//   MOVE         : Uint32 entity + float x + float y
+//   LOAD_TEXTURE : Uint16 key 长度 + key + 文件路径（其余字节），按 ImageManager_RegisterSheet 登记
+//   QUERY_STATS  : 无 payload，回复 ControlHeader + ControlStatsReply
+typedef enum ControlOpcode {
+    CONTROL_OP_PLAY_CLIP = 1,
+    CONTROL_OP_SET_SPEED = 2,
+    CONTROL_OP_MOVE = 3,
+    CONTROL_OP_LOAD_TEXTURE = 4,
+    CONTROL_OP_QUERY_STATS = 5
+} ControlOpcode;
+
+typedef struct ControlHeader {
+    Uint8 opcode;           // ControlOpcode
+    Uint8 reserved;
+    Uint16 length;          // payload 字节数
+} ControlHeader;
+
+typedef struct ControlStatsReply {
+    Uint32 entity_count;    // SpriteStore 存活实体数
+    Uint32 draw_calls;      // 以下为最近一帧的 RenderStats
+    Uint32 texture_switches;
+    Uint32 sprites;
+    float overdraw;
+} ControlStatsReply;
+
+#define CONTROL_MAX_CLIENTS 8
+#define CONTROL_MAX_PAYLOAD 1024
+#define CONTROL_RECV_BUFFER 4096
+#define CONTROL_MAX_COMMANDS_PER_FRAME 256
+
+// 单个客户端连接（接收缓冲中可能有不完整的消息）
+typedef struct ControlClient {
+    int fd;
+    Uint8 buffer[CONTROL_RECV_BUFFER];
+    int buffered;
+} ControlClient;
+
+// 控制通道
+// 录制时把每帧执行的命令写入帧日志；回放时不监听 socket，按日志在同一帧重放这些命令
+typedef struct ControlSocket {
+    int listen_fd;          // 回放实例为 -1
+    char* path;             // socket 文件路径（回放实例为 NULL）
+    ControlClient clients[CONTROL_MAX_CLIENTS];
+    int client_count;
+    FrameRecorder* recorder; // 录制：记录执行的命令；回放：命令来源
+} ControlSocket;
+
+// ========== 核心接口 ==========
+// 1. 创建并监听 socket（已存在的同名文件会被替换；Windows 下不支持，返回 NULL）
+ControlSocket* ControlSocket_Create(const char* path);
+
+// 创建回放实例：不监听 socket，Service 执行回放日志中当前帧录制的命令
+ControlSocket* ControlSocket_CreateReplay(FrameRecorder* recorder);
+
+// 录制：之后 Service 执行的命令（QUERY_STATS 除外）都写入 recorder 的当前帧
+void ControlSocket_AttachRecorder(ControlSocket* control, FrameRecorder* recorder);
+
+// 2. 非阻塞处理：接受新连接、读取数据，并批量执行全部完整命令
+//    需在 update 开始时调用：上一帧期间到达的命令在本帧模拟和绘制之前生效；返回本帧执行的命令数
+int ControlSocket_Service(ControlSocket* control, ImageManager* img_manager, SpriteStore* store, RenderStats* stats);
+
+// 3. 关闭所有连接并删除 socket 文件
+void ControlSocket_Destroy(ControlSocket* control);
+
+#endif // CONTROL_SOCKET_H
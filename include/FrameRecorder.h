@@ -0,0 +1,68 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// 日志文件格式（本机字节序，录制与回放需在同一平台）：
+//   文件头：magic "GDRP" + uint32 版本号
+//   每帧：float dt（秒） + uint16 事件数 + 事件数 * SDL_Event 原始字节
+//         + uint32 控制命令字节数 + 本帧执行的控制命令（ControlSocket 消息原样保存）
+#define FRAME_RECORDER_MAGIC   "GDRP"
+#define FRAME_RECORDER_VERSION 2u
+#define FRAME_RECORDER_MAX_EVENTS 0xFFFF
+#define FRAME_RECORDER_MAX_COMMAND_BYTES (1u << 20)
+
+// 录制/回放模式
+typedef enum FrameRecorderMode {
+    FRAME_RECORDER_RECORD,  // 录制：写出每帧 dt 和事件
+    FRAME_RECORDER_REPLAY   // 回放：按帧读回 dt 和事件
+} FrameRecorderMode;
+
+// 帧录制器（一次录制/回放会话对应一个日志文件）
+typedef struct FrameRecorder {
+    FILE* file;                 // 日志文件
+    FrameRecorderMode mode;     // 当前模式
+    Uint32 frame_count;         // 已写入/读出的帧数
+    // 当前帧的事件缓冲（录制时累积，回放时读入）
+    SDL_Event* events;
+    int event_count;
+    int event_capacity;
+    // 当前帧执行的控制命令（录制时累积，回放时读入）
+    Uint8* commands;
+    int command_bytes;
+    int command_capacity;
+    // 回放计时统计（毫秒）
+    double total_ms;
+    double min_ms;
+    double max_ms;
+} FrameRecorder;
+
+// ========== 核心接口 ==========
+// 1. 打开日志文件（录制模式会覆盖已有文件）
+FrameRecorder* FrameRecorder_Open(const char* file_path, FrameRecorderMode mode);
+
+// 2. 录制：缓存本帧事件（指针类事件如拖放文件无法回放，会被忽略）
+void FrameRecorder_PushEvent(FrameRecorder* recorder, const SDL_Event* event);
+
+// 录制：缓存本帧执行的一条控制命令（ControlSocket 消息头 + payload）
+void FrameRecorder_PushCommand(FrameRecorder* recorder, const void* data, int length);
+
+// 3. 录制：写出本帧 dt、已缓存事件和控制命令，并清空缓冲
+bool FrameRecorder_WriteFrame(FrameRecorder* recorder, float dt);
+
+// 4. 回放：读出下一帧（文件结束或损坏时返回 false）
+bool FrameRecorder_ReadFrame(FrameRecorder* recorder, float* dt, const SDL_Event** events, int* event_count);
+// 回放：当前帧录制的控制命令（ReadFrame 之后有效）
+const Uint8* FrameRecorder_GetCommands(const FrameRecorder* recorder, int* length);
+
+// 5. 回放：记录一帧的 CPU 耗时并输出到 stdout
+void FrameRecorder_ReportFrame(FrameRecorder* recorder, float dt, double frame_ms);
+
+// 6. 关闭日志文件（回放模式会输出汇总统计）
+void FrameRecorder_Close(FrameRecorder* recorder);
+
+#endif // FRAME_RECORDER_H
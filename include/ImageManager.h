@@ -6,11 +6,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 
 // 缓存节点结构体：存储纹理+key+引用计数（可选）
 typedef struct ImageCacheNode {
     char* key;                // 图片唯一标识（如路径）
-    SDL_Texture* texture;     // 缓存的纹理
+    char* file_path;          // 源文件路径（按需重新解码像素用）
+    SDL_Texture* texture;     // 缓存的纹理（RegisterSheet / LoadIndexed 注册的为 NULL）
+    SDL_Surface* indexed;     // 8 位索引像素（LoadIndexed 加载，所有调色板变体共享）
     int ref_count;            // 引用计数（可选，防止误释放）
     struct ImageCacheNode* next; // 链表下一个节点
 } ImageCacheNode;
@@ -28,16 +31,29 @@ ImageManager* ImageManager_GetInstance(SDL_Renderer* renderer);
 // 2. 加载纹理（自动缓存，重复加载返回已有纹理）
 SDL_Texture* ImageManager_LoadTexture(ImageManager* manager, const char* key, const char* file_path);
 
-// 3. 获取已缓存的纹理
+// 3. 注册精灵图但不上传纹理（超出渲染器尺寸上限或只用到部分行的大图）
+//    AnimationManager 会按需分块上传；GetTexture 对此类 key 返回 NULL
+bool ImageManager_RegisterSheet(ImageManager* manager, const char* key, const char* file_path);
+
+// 4. 加载 8 位索引精灵图（只保留索引像素，颜色由 PaletteManager 在绘制时解析）
+//    图片须为调色板 PNG 等 8 位索引格式
+SDL_Surface* ImageManager_LoadIndexed(ImageManager* manager, const char* key, const char* file_path);
+
+// 5. 获取已缓存的纹理 / 索引像素 / 源文件路径
 SDL_Texture* ImageManager_GetTexture(ImageManager* manager, const char* key);
+SDL_Surface* ImageManager_GetIndexed(ImageManager* manager, const char* key);
+const char* ImageManager_GetPath(ImageManager* manager, const char* key);
 
-// 4. 释放单个纹理（引用计数为0时真正释放）
+// 6. 释放单个纹理（引用计数为0时真正释放）
 void ImageManager_ReleaseTexture(ImageManager* manager, const char* key);
 
-// 5. 清空所有缓存纹理
+// 7. 重新解码已缓存纹理的源图片（供读取像素，调用方负责 SDL_FreeSurface）
+SDL_Surface* ImageManager_LoadSurface(ImageManager* manager, const char* key);
+
+// 8. 清空所有缓存纹理
 void ImageManager_ClearCache(ImageManager* manager);
 
-// 6. 销毁ImageManager单例（释放所有资源）
+// 9. 销毁ImageManager单例（释放所有资源）
 void ImageManager_DestroyInstance();
 
 #endif // IMAGE_MANAGER_H
\ No newline at end of file
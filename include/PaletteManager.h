@@ -0,0 +1,90 @@
+#ifndef PALETTE_MANAGER_H
+#define PALETTE_MANAGER_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+
+// 展开缓存：连续多少帧未使用的纹理会被释放，以及多久扫描一次
+#define PALETTE_CACHE_EVICT_FRAMES 300
+#define PALETTE_CACHE_SWEEP_INTERVAL 60
+#define PALETTE_CACHE_BUCKETS 256
+
+// 调色板（创建后不可修改，随管理器一起释放）
+typedef struct SpritePalette {
+    char* name;             // 调色板名称（索引精灵图自带的调色板以 anim_key 命名）
+    SDL_Color colors[256];  // 索引 -> 颜色（超出 color_count 的索引为全透明）
+    int color_count;
+    // 软件路径：按目标表面像素格式映射后的查找表（首次 LUT 绘制时生成）
+    Uint32 lut[256];
+    Uint32 lut_format;      // lut 对应的像素格式（0 表示未生成）
+} SpritePalette;
+
+// 展开缓存项：某个动画分块用某个调色板展开后的 RGBA 纹理
+typedef struct PaletteCacheEntry {
+    const Animation* anim;
+    int tile;
+    const SpritePalette* palette;
+    SDL_Texture* texture;
+    Uint32 last_used;       // 最近一次使用的帧号
+    struct PaletteCacheEntry* next;
+} PaletteCacheEntry;
+
+// 调色板管理器（由 AnimationManager 创建和持有）
+// 展开缓存只在渲染器所在线程访问：使用渲染线程时 Draw/EndFrame/ForgetAnimation 都由渲染线程调用
+// 索引精灵图只保留一份 8 位像素（ImageManager 共享），颜色在绘制时按调色板解析：
+//   软件渲染器且设置了目标表面：查表直接写入目标表面（不创建纹理）
+//   其他渲染器：按 (分块, 调色板) 懒创建展开纹理，长时间未使用后释放
+typedef struct PaletteManager {
+    SpritePalette** palettes;
+    int palette_count;
+    PaletteCacheEntry* buckets[PALETTE_CACHE_BUCKETS];
+    int entry_count;        // 当前展开纹理数
+    Uint32 frame;           // 帧号（EndFrame 递增）
+    SDL_Renderer* renderer;
+    SDL_Surface* target;    // 软件渲染器的目标表面（NULL 表示不走查表绘制）
+    bool software;          // 渲染器是否为软件渲染器
+} PaletteManager;
+
+// ========== 核心接口 ==========
+// 1. 创建调色板管理器（renderer 可为 NULL：渲染线程模式下由 RenderQueue_Attach 绑定渲染线程的渲染器）
+PaletteManager* PaletteManager_Create(SDL_Renderer* renderer);
+
+// 2. 添加调色板（colors 最多 256 个；同名已存在时返回已有的）
+SpritePalette* PaletteManager_AddPalette(PaletteManager* manager, const char* name, const SDL_Color* colors, int color_count);
+
+// 3. 按名称查找调色板
+SpritePalette* PaletteManager_GetPalette(PaletteManager* manager, const char* name);
+
+// 4. 设置软件渲染器的目标表面（即 SDL_CreateSoftwareRenderer 的表面），启用查表绘制
+void PaletteManager_SetTarget(PaletteManager* manager, SDL_Surface* target);
+
+// 5. 用调色板绘制索引动画的一帧（palette 为 NULL 时用精灵图自带调色板）
+//    须在渲染器所在线程调用；旋转时总是走展开纹理
+void PaletteManager_Draw(
+    PaletteManager* manager,
+    const Animation* anim,
+    int tile,                   // 帧所在分块
+    const SpritePalette* palette,
+    const SDL_Rect* src,        // 分块内的源矩形
+    const SDL_Rect* dst,
+    double angle,               // 旋转角度（度）
+    SDL_RendererFlip flip
+);
+
+// 6. 每帧 Present 后调用：推进帧号并定期释放长时间未使用的展开纹理
+void PaletteManager_EndFrame(PaletteManager* manager);
+
+// 7. 释放某个动画的全部展开纹理（销毁动画前调用）
+void PaletteManager_ForgetAnimation(PaletteManager* manager, const Animation* anim);
+
+// 8. 释放全部展开纹理（渲染线程退出前在渲染线程调用）
+void PaletteManager_ReleaseTextures(PaletteManager* manager);
+
+// 9. 销毁管理器（释放全部调色板和剩余的展开纹理）
+void PaletteManager_Destroy(PaletteManager* manager);
+
+#endif // PALETTE_MANAGER_H
@@ -0,0 +1,90 @@
+#ifndef PARTICLE_EMITTER_H
+#define PARTICLE_EMITTER_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+#include "RenderStats.h"
+
+#define PARTICLE_EMITTER_MAX_CAPACITY (1 << 24)
+
+// 粒子发射器（容量固定，创建后不再分配内存）
+// 粒子按组件连续存放，存活粒子始终位于 [0, count)，死亡用 swap-remove
+// 外观来自动画序列：粒子按年龄逐帧播放序列，帧矩形即 AnimationFrame 的 src
+// 绘制时整个发射器拼成一次 SDL_RenderGeometry（序列帧须位于同一分块）
+typedef struct ParticleEmitter {
+    int capacity;
+    int count;              // 存活粒子数
+
+    // 粒子组件（稠密数组）
+    float* x;               // 位置（绘制中心）
+    float* y;
+    float* vx;              // 速度（像素/秒）
+    float* vy;
+    float* age;             // 已存活时间（秒）
+    float* life;            // 寿命（秒）
+    int* frame;             // 当前帧在序列中的位置（Update 时按年龄计算）
+
+    // 外观
+    Animation* anim;
+    const AnimationClip* clip;
+    float* frame_uv;        // 序列每帧的纹理坐标 u0,v0,u1,v1
+    float frame_w;          // 帧绘制尺寸（已乘 scale）
+    float frame_h;
+    int tile;               // 序列所在分块
+    bool fade;              // 按剩余寿命淡出
+
+    // 发射参数
+    float origin_x;
+    float origin_y;
+    float angle;            // 发射方向（弧度）
+    float spread;           // 方向随机范围（±spread/2）
+    float speed_min;
+    float speed_max;
+    float life_min;
+    float life_max;
+    float gravity_x;        // 加速度（像素/秒²）
+    float gravity_y;
+    float rate;             // 每秒连续发射数（0 为只手动发射）
+    float rate_accum;
+    Uint32 rng;             // xorshift32 状态（固定种子，回放可复现）
+
+    // 绘制缓冲（创建时按容量分配：每粒子 4 顶点 6 索引）
+    SDL_Vertex* vertices;
+    int* indices;
+
+    AnimationManager* anim_manager;
+    SDL_Renderer* renderer;
+    RenderStats* stats;
+} ParticleEmitter;
+
+// ========== 核心接口 ==========
+// 1. 创建发射器（clip_name 为粒子外观序列；会先上传序列用到的分块）
+ParticleEmitter* ParticleEmitter_Create(AnimationManager* anim_manager, Animation* anim, const char* clip_name, int capacity);
+
+// 2. 发射参数
+void ParticleEmitter_SetOrigin(ParticleEmitter* emitter, float x, float y);
+void ParticleEmitter_SetEmission(ParticleEmitter* emitter, float angle, float spread, float speed_min, float speed_max, float life_min, float life_max);
+void ParticleEmitter_SetGravity(ParticleEmitter* emitter, float gravity_x, float gravity_y);
+void ParticleEmitter_SetRate(ParticleEmitter* emitter, float rate);
+void ParticleEmitter_SetAppearance(ParticleEmitter* emitter, float scale, bool fade);
+
+// 3. 在发射点立即发射 n 个粒子（满时截断），返回实际发射数
+int ParticleEmitter_Emit(ParticleEmitter* emitter, int n);
+
+// 4. 更新：连续发射、年龄/运动积分、回收死亡粒子、计算帧
+void ParticleEmitter_Update(ParticleEmitter* emitter, float dt);
+
+// 5. 绘制全部存活粒子（一次批量调用）
+void ParticleEmitter_Draw(ParticleEmitter* emitter);
+
+// 6. 清空全部粒子
+void ParticleEmitter_Clear(ParticleEmitter* emitter);
+
+// 7. 销毁发射器
+void ParticleEmitter_Destroy(ParticleEmitter* emitter);
+
+#endif // PARTICLE_EMITTER_H
@@ -0,0 +1,99 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+
+// 单条绘制命令（纹理以 动画 + 分块下标 标识，由渲染线程解析，未上传的分块在渲染线程上传）
+typedef struct DrawCommand {
+    Animation* anim;        // 分块所属动画
+    int tile;               // 分块下标
+    const struct SpritePalette* palette; // 索引动画的调色板（NULL 为自带）
+    SDL_Rect src;           // 分块纹理中的源矩形
+    SDL_Rect dst;           // 目标矩形
+    float angle;            // 旋转角度（度）
+    Uint8 flip;             // SDL_RendererFlip
+    // 批量四边形命令（quad_count > 0）：顶点在 DrawList.vertices 中，每四边形 4 个顶点
+    int vertex_offset;
+    int quad_count;
+} DrawCommand;
+
+struct RenderQueue;
+
+// 延迟任务：在渲染线程执行完录制它的那一帧之后运行（销毁纹理、释放动画等）
+typedef void (*RenderQueueTask)(struct RenderQueue* queue, void* data);
+
+typedef struct RenderTask {
+    RenderQueueTask run;
+    void* data;
+} RenderTask;
+
+// 一帧的命令列表
+typedef struct DrawList {
+    DrawCommand* commands;
+    int count;
+    int capacity;
+    SDL_Vertex* vertices;   // 批量命令的顶点
+    int vertex_count;
+    int vertex_capacity;
+    RenderTask* tasks;      // 本帧绘制完成后执行的任务
+    int task_count;
+    int task_capacity;
+} DrawList;
+
+// 渲染队列：模拟线程录制一帧命令，渲染线程（独占 SDL_Renderer）执行上一帧并 Present
+// 所有纹理都在渲染线程创建和销毁：分块在首次绘制时上传，释放通过 RenderQueue_Defer 排在引用它的帧之后
+// 此模式下 ImageManager / AnimationManager 的 renderer 为 NULL，主线程误用会直接报错
+typedef struct RenderQueue {
+    DrawList lists[2];      // 双缓冲
+    int record;             // 模拟线程正在录制的列表
+    int pending;            // 已提交、等待渲染的列表（-1 表示无）
+    int rendering;          // 渲染线程正在执行的列表（-1 表示空闲）
+    bool ready;             // 渲染线程已完成渲染器创建（成功或失败）
+    bool quit;
+
+    SDL_Thread* thread;
+    SDL_mutex* mutex;
+    SDL_cond* cond;
+
+    SDL_Window* window;
+    SDL_Renderer* renderer; // 由渲染线程创建和销毁，只能在渲染线程使用
+    SDL_threadID thread_id; // 渲染线程 ID（检查 GPU 资源是否在正确线程创建）
+    int max_texture_w;      // 渲染器纹理尺寸上限（渲染线程查询，0 表示未报告）
+    int max_texture_h;
+    bool software;          // 是否软件渲染器
+    AnimationManager* anim_manager; // 分块按需上传
+    int* quad_indices;      // 四边形索引（渲染线程独占，按需增长）
+    int quad_capacity;
+    int* upload_tiles;      // 本帧待上传分块下标（渲染线程）
+    int upload_capacity;
+} RenderQueue;
+
+// ========== 核心接口 ==========
+// 1. 启动渲染线程并在其中创建渲染器（阻塞到渲染器创建完成，失败返回 NULL）
+RenderQueue* RenderQueue_Create(SDL_Window* window);
+
+// 2. 关联动画管理器（须以 NULL 渲染器创建）：之后 AnimationManager_Draw / SpriteStore_DrawAll 改为录制命令
+void RenderQueue_Attach(RenderQueue* queue, AnimationManager* anim_manager);
+
+// 3. 录制一条绘制命令（模拟线程）
+void RenderQueue_Push(RenderQueue* queue, Animation* anim, int tile, const struct SpritePalette* palette, const SDL_Rect* src, const SDL_Rect* dst, float angle, SDL_RendererFlip flip);
+
+// 录制一次批量四边形绘制（顶点按 左上/右上/左下/右下 排列，会被复制）
+void RenderQueue_PushGeometry(RenderQueue* queue, Animation* anim, int tile, const SDL_Vertex* vertices, int quad_count);
+
+// 录制一个延迟任务：渲染线程执行完本帧命令后运行（队列销毁时未提交的任务也会执行）
+void RenderQueue_Defer(RenderQueue* queue, RenderQueueTask task, void* data);
+
+// 4. 提交本帧：交给渲染线程，切换到另一块缓冲继续录制
+//    仅当渲染线程仍在使用另一块缓冲（上上帧）时等待
+void RenderQueue_Submit(RenderQueue* queue);
+
+// 5. 停止渲染线程：执行剩余任务，释放动画管理器的全部纹理，再销毁渲染器
+void RenderQueue_Destroy(RenderQueue* queue);
+
+#endif // RENDER_QUEUE_H
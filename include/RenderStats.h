@@ -0,0 +1,62 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define RENDER_STATS_HISTORY 120 // 滚动统计窗口（帧数）
+
+// 单帧渲染统计（每帧清屏时重置）
+typedef struct RenderFrameStats {
+    Uint32 clears;            // 清屏次数
+    Uint32 draw_calls;        // 绘制调用次数
+    Uint32 texture_switches;  // 纹理切换次数（与上一次绘制的纹理不同）
+    Uint32 sprites;           // 提交的精灵数
+    Uint64 pixels_filled;     // 精灵填充像素数（按目标矩形裁剪到屏幕）
+    float overdraw;           // 过度绘制比例（pixels_filled / 屏幕像素）
+} RenderFrameStats;
+
+// 滚动窗口内的 最小/平均/最大 统计
+typedef struct RenderStatsSummary {
+    RenderFrameStats min;
+    RenderFrameStats avg;
+    RenderFrameStats max;
+    int frame_count;          // 参与统计的帧数
+} RenderStatsSummary;
+
+// 渲染统计（全局唯一）
+typedef struct RenderStats {
+    RenderFrameStats current;                        // 正在累计的帧
+    RenderFrameStats last;                           // 最近完成的帧
+    RenderFrameStats history[RENDER_STATS_HISTORY];  // 环形历史
+    int history_count;
+    int history_head;
+    const void* last_texture;                        // 上一次绘制的纹理标识
+    int screen_w;
+    int screen_h;
+} RenderStats;
+
+// ========== 核心接口 ==========
+// 1. 获取全局统计实例
+RenderStats* RenderStats_GetInstance(void);
+
+// 2. 帧开始（在 SDL_RenderClear 处调用）：重置当前帧计数
+void RenderStats_BeginFrame(RenderStats* stats, SDL_Renderer* renderer);
+
+// 3. 记录一次精灵绘制（texture 为纹理标识：纹理或分块指针，只比较是否相同）
+void RenderStats_RecordDraw(RenderStats* stats, const void* texture, const SDL_Rect* dst_rect);
+// 记录一次批量绘制（一次调用画 sprites 个精灵，pixels 为未裁剪的总填充像素）
+void RenderStats_RecordBatch(RenderStats* stats, const void* texture, int sprites, Uint64 pixels);
+
+// 4. 帧结束（在 SDL_RenderPresent 后调用）：写入历史
+void RenderStats_EndFrame(RenderStats* stats);
+
+// 5. 查询最近完成的一帧
+const RenderFrameStats* RenderStats_GetLastFrame(const RenderStats* stats);
+
+// 6. 查询滚动窗口的 最小/平均/最大 值
+bool RenderStats_GetSummary(const RenderStats* stats, RenderStatsSummary* summary);
+
+#endif // RENDER_STATS_H
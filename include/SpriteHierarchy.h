@@ -0,0 +1,82 @@
+#ifndef SPRITE_HIERARCHY_H
+#define SPRITE_HIERARCHY_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+#include "SpriteStore.h"
+
+// 挂接节点：子精灵相对父精灵挂点的局部变换，以及上次更新得到的世界变换
+typedef struct SpriteAttachment {
+    SpriteEntity entity;
+    int parent;             // 父节点下标（排序后总小于自身；根为 -1）
+    int depth;              // 根为 0
+    int anchor;             // 父动画的挂点下标（-1 为父帧中心）
+    // 局部变换（父帧像素空间，随父节点缩放/旋转/翻转）
+    float local_x;
+    float local_y;
+    float local_scale;
+    float local_rotation;   // 弧度
+    Uint8 local_flip;       // 与父节点翻转异或
+    // 世界变换（上次更新写入 SpriteStore 的值；与当前值不同说明被外部改动）
+    float x;
+    float y;
+    float scale;
+    float rotation;
+    Uint8 flip;
+    int frame;              // 上次更新时自身的帧（子节点的挂点随之变化）
+    bool dirty;             // 需要重算：局部变换、父子关系改变或 SpriteStore 登记了变更
+} SpriteAttachment;
+
+// 精灵挂接层级（武器、帽子、特效等跟随父精灵挂点）
+// 节点按先序存放在一个数组中，父节点总在子节点之前，每棵子树占据连续区间
+// Update 只遍历 SpriteStore 变更列表中的节点所在的子树，静止的层级每帧没有遍历开销
+// 一个 SpriteStore 只能挂一个层级（Update 消费并清空其变更列表）
+// 根节点的位置等由 SpriteStore 正常驱动；子节点的位置、缩放、旋转、翻转由层级写入
+typedef struct SpriteHierarchy {
+    SpriteStore* store;
+    int capacity;           // 最大节点数（创建时固定）
+    int count;
+    SpriteAttachment* nodes;
+    int* node_of;           // 实体索引 -> 节点下标（-1 为不在层级中）
+    int* dense;             // 更新时各节点的 SpriteStore 稠密下标
+    Uint8* changed;         // 更新时各节点世界变换或帧是否改变
+    int* subtree_end;       // 节点子树区间的末尾（不含）
+    int* seeds;             // 更新时登记了变更的节点下标
+    bool order_dirty;       // 父子关系改变，需要按先序重排
+    int* first_child;       // 重排时的子节点链表
+    int* next_sibling;
+    SpriteAttachment* scratch; // 重排缓冲
+    int* remap;             // 重排时旧下标 -> 新下标
+    int recomputed;         // 上次 Update 重新组合变换的子节点数
+    int visited;            // 上次 Update 遍历的节点数（变化子树的大小之和）
+} SpriteHierarchy;
+
+// ========== 核心接口 ==========
+// 1. 创建挂接层级（容量固定，运行中不再分配内存）
+SpriteHierarchy* SpriteHierarchy_Create(SpriteStore* store, int capacity);
+
+// 2. 把 child 挂到 parent 的挂点上（anchor_name 为 NULL 时挂在父帧中心），(local_x, local_y) 为相对挂点的偏移
+//    child 已有父节点时改挂；会形成环时失败
+bool SpriteHierarchy_Attach(SpriteHierarchy* hierarchy, SpriteEntity child, SpriteEntity parent, const char* anchor_name, float local_x, float local_y);
+
+// 3. 设置子节点局部变换
+void SpriteHierarchy_SetLocal(SpriteHierarchy* hierarchy, SpriteEntity child, float local_x, float local_y, float scale, float rotation, SDL_RendererFlip flip);
+
+// 4. 从父节点摘下（子树保留，entity 成为根，停在当前世界变换）
+void SpriteHierarchy_Detach(SpriteHierarchy* hierarchy, SpriteEntity entity);
+
+// 5. 从层级中移除（其子节点成为根）；SpriteStore 中已销毁的实体在 Update 时自动移除
+void SpriteHierarchy_Remove(SpriteHierarchy* hierarchy, SpriteEntity entity);
+
+// 6. 更新世界变换并写入 SpriteStore（在 SpriteStore_Update 之后、SpriteStore_DrawAll 之前调用）
+//    只遍历变化的子树；直接改写 SpriteStore 组件数组的代码需调用 SpriteStore_MarkChanged
+void SpriteHierarchy_Update(SpriteHierarchy* hierarchy);
+
+// 7. 销毁挂接层级（不影响 SpriteStore 中的实体）
+void SpriteHierarchy_Destroy(SpriteHierarchy* hierarchy);
+
+#endif // SPRITE_HIERARCHY_H
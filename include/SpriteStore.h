@@ -0,0 +1,116 @@
+#ifndef SPRITE_STORE_H
+#define SPRITE_STORE_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+#include "PaletteManager.h"
+#include "RenderStats.h"
+
+// 实体句柄：低 24 位为稀疏索引，高 8 位为代数（防止销毁后句柄被误用）
+typedef Uint32 SpriteEntity;
+#define SPRITE_ENTITY_INVALID    0xFFFFFFFFu
+#define SPRITE_ENTITY_INDEX_BITS 24
+#define SPRITE_ENTITY_INDEX_MASK ((1u << SPRITE_ENTITY_INDEX_BITS) - 1)
+#define SPRITE_STORE_MAX_CAPACITY ((1 << SPRITE_ENTITY_INDEX_BITS) - 1)
+
+// 精灵实体存储（稀疏集合：稀疏数组映射句柄，稠密数组按组件连续存放）
+// 删除采用 swap-remove，稠密数组始终紧凑；按 layer 排序在绘制前惰性完成
+// 注意：实体引用的 Animation 必须比实体存活更久
+typedef struct SpriteStore {
+    int capacity;           // 最大实体数（创建时固定）
+    int count;              // 存活实体数（稠密数组长度）
+
+    // 稀疏部分（按实体索引）
+    Uint32* sparse;         // 实体索引 -> 稠密下标
+    Uint8* generation;      // 实体索引当前代数
+    Uint32* free_indices;   // 回收的实体索引栈
+    int free_count;
+    int next_index;         // 尚未使用过的最小实体索引
+
+    // 稠密部分（每个组件一段连续数组）
+    SpriteEntity* entities; // 稠密下标 -> 实体句柄
+    float* x;               // 位置（绘制中心）
+    float* y;
+    float* vx;              // 速度（像素/秒）
+    float* vy;
+    float* scale;           // 缩放
+    float* rotation;        // 旋转（弧度）
+    int* layer;             // 绘制层（小的先画）
+    Uint8* flip;            // SDL_RendererFlip
+    SpritePalette** palette; // 索引动画的调色板（NULL 为精灵图自带）
+    // 动画实例（每个实体独立的播放状态）
+    Animation** anim;       // 帧矩形来源
+    AnimationClip** clip;   // 当前序列（NULL 表示停在第 0 帧）
+    float* elapsed;         // 当前帧已播放时间
+    float* speed;           // 播放速度
+    int* cursor;            // 序列中的位置
+    Uint8* playing;         // 是否播放中
+
+    bool order_dirty;       // layer 顺序是否需要重排
+    // 变更列表（按实体索引，每个索引至多一次，长度以容量为上限）
+    // 位置、缩放/旋转/翻转、当前帧改变或实体销毁时登记，供 SpriteHierarchy 只处理变化的实体
+    Uint32* changed;
+    int changed_count;
+    Uint8* changed_flag;    // 实体索引是否已在变更列表中
+    Uint64* sort_keys;      // 排序缓冲
+    void* scratch;          // 重排缓冲
+
+    AnimationManager* anim_manager; // 播放时按需上传分块
+    SDL_Renderer* renderer;
+    RenderStats* stats;
+} SpriteStore;
+
+// ========== 核心接口 ==========
+// 1. 创建实体存储（容量固定，运行中不再分配内存）
+SpriteStore* SpriteStore_Create(AnimationManager* anim_manager, int capacity);
+
+// 2. 创建实体（满时返回 SPRITE_ENTITY_INVALID）
+SpriteEntity SpriteStore_CreateEntity(SpriteStore* store, Animation* anim, float x, float y);
+
+// 3. 销毁实体（swap-remove）
+bool SpriteStore_DestroyEntity(SpriteStore* store, SpriteEntity entity);
+
+// 4. 句柄是否仍然有效
+bool SpriteStore_IsAlive(const SpriteStore* store, SpriteEntity entity);
+
+// 5. 组件设置
+void SpriteStore_SetPosition(SpriteStore* store, SpriteEntity entity, float x, float y);
+void SpriteStore_SetVelocity(SpriteStore* store, SpriteEntity entity, float vx, float vy);
+void SpriteStore_SetTransform(SpriteStore* store, SpriteEntity entity, float scale, float rotation, SDL_RendererFlip flip);
+void SpriteStore_SetLayer(SpriteStore* store, SpriteEntity entity, int layer);
+void SpriteStore_SetSpeed(SpriteStore* store, SpriteEntity entity, float speed);
+void SpriteStore_SetPalette(SpriteStore* store, SpriteEntity entity, SpritePalette* palette); // 仅对索引动画生效
+
+// 6. 播放实体动画序列（仅在此处按名称查找一次）
+bool SpriteStore_Play(SpriteStore* store, SpriteEntity entity, const char* clip_name);
+
+// 7. 更新：运动积分 + 动画推进（线性遍历稠密数组）
+void SpriteStore_Update(SpriteStore* store, float dt);
+
+// 8. 按 layer 顺序绘制全部实体
+void SpriteStore_DrawAll(SpriteStore* store);
+
+// 9. 像素级命中测试：返回 (px, py) 处最上层的不透明实体（无则 SPRITE_ENTITY_INVALID）
+//    按 scale/flip 换算到帧内坐标后查 Alpha 掩码，旋转不参与
+SpriteEntity SpriteStore_HitTest(SpriteStore* store, int px, int py);
+
+// 10. 两个实体是否有不透明像素重叠（同一整数缩放且偏移为整纹素时按掩码字 AND，否则按纹素边界切格采样，结果与逐像素一致）
+bool SpriteStore_Overlap(SpriteStore* store, SpriteEntity a, SpriteEntity b);
+
+// 11. 稠密下标（无效为 -1）与该下标的当前帧索引，供 SpriteHierarchy 等批量读写组件
+//     下标在销毁实体或按 layer 重排后失效，不可跨帧保存
+int SpriteStore_DenseIndex(const SpriteStore* store, SpriteEntity entity);
+int SpriteStore_FrameAt(const SpriteStore* store, int dense);
+
+// 12. 变更通知：直接写组件数组后调用 MarkChanged 登记；ClearChanged 由消费方（SpriteHierarchy_Update）在处理后调用
+void SpriteStore_MarkChanged(SpriteStore* store, SpriteEntity entity);
+void SpriteStore_ClearChanged(SpriteStore* store);
+
+// 13. 销毁实体存储
+void SpriteStore_Destroy(SpriteStore* store);
+
+#endif // SPRITE_STORE_H
@@ -0,0 +1,89 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+#include "RenderStats.h"
+
+#define TEXT_CACHE_BUCKETS 64
+#define TEXT_CACHE_MAX_ENTRIES 128  // 超出时淘汰最久未用的排版结果
+
+// 一段使用同一分块纹理的连续字形
+typedef struct TextBatch {
+    int tile;               // 字形表分块
+    int first_quad;
+    int quad_count;
+} TextBatch;
+
+// 静态字符串的排版缓存（顶点相对文本左上角，白色，已按分块分组，绘制时平移并着色）
+typedef struct TextCacheEntry {
+    char* text;
+    float scale;
+    SDL_Vertex* vertices;
+    int quad_count;
+    TextBatch* batches;
+    int batch_count;
+    int w;                  // 排版后尺寸（像素）
+    int h;
+    Uint32 last_used;
+    struct TextCacheEntry* next;
+} TextCacheEntry;
+
+// 位图字体文本渲染器
+// 字形表即一个 Animation：按 AnimationManager_LoadAnimation 的行列切分，帧 i = 字符 first_char + i
+// （字形用白色绘制，颜色由顶点色调制）
+// 每个文本块排版进复用的顶点缓冲，按字形所在分块分组后每个分块一次 SDL_RenderGeometry 提交
+// （RegisterSheet 注册的字形表每行一个分块），绘制时不分配内存
+typedef struct TextRenderer {
+    Animation* atlas;
+    int first_char;
+    int glyph_count;
+    int cell_w;             // 字形格尺寸（帧尺寸）
+    int cell_h;
+    float* glyph_uv;        // 每个字形在所在分块中的纹理坐标 u0,v0,u1,v1
+    int* glyph_left;        // 字形左侧空白列数（等宽字体为 0）
+    int* glyph_advance;     // 字形步进（等宽字体为 cell_w）
+
+    int capacity;           // 单个文本块最多字形数
+    SDL_Vertex* layout;     // 排版缓冲（按字符顺序，每字形 4 顶点）
+    int* quad_tile;         // 排版缓冲中各字形所在分块
+    SDL_Vertex* vertices;   // 提交缓冲（按分块分组）
+    int* indices;           // 四边形索引（创建时生成）
+    int* tile_quads;        // 分组时各分块的字形计数/写入位置
+    TextBatch* batches;     // 提交缓冲的分块批次
+    int batch_count;
+    int max_batches;        // min(分块数, capacity)
+
+    TextCacheEntry* buckets[TEXT_CACHE_BUCKETS];
+    int entry_count;
+    Uint32 use_counter;
+
+    AnimationManager* anim_manager;
+    SDL_Renderer* renderer;
+    RenderStats* stats;
+} TextRenderer;
+
+// ========== 核心接口 ==========
+// 1. 创建文本渲染器（capacity 为单个文本块最多字形数；proportional 时按字形 Alpha 掩码裁掉左右空白列）
+TextRenderer* TextRenderer_Create(AnimationManager* anim_manager, Animation* atlas, int first_char, int capacity, bool proportional);
+
+// 2. 测量文本尺寸（支持 '\n' 换行）
+void TextRenderer_Measure(TextRenderer* text, const char* str, float scale, int* w, int* h);
+
+// 3. 绘制动态文本（每次重新排版，如帧率），(x, y) 为左上角，超出 capacity 的字形不绘制
+void TextRenderer_Draw(TextRenderer* text, const char* str, float x, float y, float scale, SDL_Color color);
+
+// 4. 绘制静态文本（按内容和缩放缓存排版结果，再次绘制只平移和着色）
+void TextRenderer_DrawStatic(TextRenderer* text, const char* str, float x, float y, float scale, SDL_Color color);
+
+// 5. 清空排版缓存
+void TextRenderer_ClearCache(TextRenderer* text);
+
+// 6. 销毁文本渲染器
+void TextRenderer_Destroy(TextRenderer* text);
+
+#endif // TEXT_RENDERER_H
@@ -0,0 +1,75 @@
+#ifndef TILE_MAP_H
+#define TILE_MAP_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "AnimationManager.h"
+#include "RenderStats.h"
+
+#define TILEMAP_CHUNK_SIZE 16       // 每个区块 16x16 格
+#define TILEMAP_EMPTY 0xFFFF        // 空格（不绘制）
+
+// 区块内使用同一分块纹理的一段连续四边形
+typedef struct TileBatch {
+    int tile;               // 图块集分块
+    int first_quad;
+    int quad_count;
+} TileBatch;
+
+// 区块：缓存区块内全部非空格子的四边形（地图坐标，按分块分组），格子改变时才重建
+typedef struct TileChunk {
+    SDL_Vertex* vertices;   // 每个非空格子 4 个顶点
+    int quad_count;
+    int quad_capacity;
+    TileBatch* batches;     // 每个用到的分块一段
+    int batch_count;
+    bool dirty;
+} TileChunk;
+
+// 瓦片地图层
+// 图块集即一个 Animation：按 AnimationManager_LoadAnimation 的行列切分，图块编号 = 帧索引
+// 绘制时每个可见区块按用到的分块各一次 SDL_RenderGeometry（图块集只占一个分块时即一次）
+typedef struct TileMap {
+    int width;              // 地图尺寸（格）
+    int height;
+    int tile_w;             // 单格像素尺寸（图块集帧尺寸）
+    int tile_h;
+    Uint16* tiles;          // width * height 个图块编号
+
+    int chunks_x;           // 区块行列数
+    int chunks_y;
+    TileChunk* chunks;
+
+    Animation* tileset;
+    float* tile_uv;         // 每个图块在所在分块中的纹理坐标 u0,v0,u1,v1
+    int* tile_quads;        // 重建区块时各分块的四边形计数/写入位置
+
+    SDL_Vertex* scratch;    // 绘制时平移后的顶点（一个区块）
+    int* indices;           // 一个区块的四边形索引（创建时生成）
+
+    AnimationManager* anim_manager;
+    SDL_Renderer* renderer;
+    RenderStats* stats;
+} TileMap;
+
+// ========== 核心接口 ==========
+// 1. 创建地图层（全部为空格；不使用渲染线程时会先上传图块集的全部分块）
+TileMap* TileMap_Create(AnimationManager* anim_manager, Animation* tileset, int width, int height);
+
+// 2. 设置/读取单格（设置时所在区块标记为待重建）
+void TileMap_SetTile(TileMap* map, int tx, int ty, Uint16 tile);
+Uint16 TileMap_GetTile(const TileMap* map, int tx, int ty);
+
+// 3. 整体载入 width * height 个图块编号（按行存放）
+bool TileMap_Load(TileMap* map, const Uint16* tiles);
+
+// 4. 绘制：view 为屏幕左上角对应的地图像素区域（宽高为屏幕尺寸），只画与之相交的区块
+void TileMap_Draw(TileMap* map, const SDL_Rect* view);
+
+// 5. 销毁地图层
+void TileMap_Destroy(TileMap* map);
+
+#endif // TILE_MAP_H
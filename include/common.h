@@ -3,6 +3,8 @@
 #include<SDL2/SDL.h>
 #include "AnimationManager.h"
 #include "ImageManager.h"
+#include "SpriteStore.h"
+#include "ControlSocket.h"
 
 
 
@@ -13,6 +15,8 @@ typedef struct {
     int WIN_HEIGHT;
     ImageManager* imageManager;
     AnimationManager* g_anim_manager;
+    SpriteStore* g_sprite_store;
+    ControlSocket* g_control;   // 本地控制通道（未启用时为 NULL）
 }CommonS;
 
 extern CommonS *commons;
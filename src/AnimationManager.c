@@ -1,5 +1,7 @@
 #include "AnimationManager.h"
 #include "ImageManager.h"
+#include "RenderQueue.h"
+#include "PaletteManager.h"
 
 // ========== 内部辅助函数 ==========
 // 查找动画对象
@@ -24,24 +26,274 @@ static AnimationClip* find_clip(Animation* anim, const char* clip_name) {
     return NULL;
 }
 
-// 计算精灵图单帧矩形
-static void calculate_frame_rects(Animation* anim) {
-    if (!anim || !anim->texture) return;
+// 从解码后的表面为每帧生成 1-bit Alpha 掩码（正向 + 水平翻转各一份）
+static void build_alpha_masks(Animation* anim, SDL_Surface* surface) {
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!rgba) {
+        fprintf(stderr, "AnimationManager: Failed to convert surface for alpha masks: %s\n", SDL_GetError());
+        return;
+    }
+
+    int frame_w = anim->frames[0].rect.w;
+    int frame_h = anim->frames[0].rect.h;
+    anim->mask_stride = (frame_w + 63) / 64;
+    anim->mask_words = anim->mask_stride * frame_h;
+
+    size_t words = (size_t)anim->mask_words * anim->total_frames;
+    anim->alpha_masks = (Uint64*)calloc(words * 2, sizeof(Uint64));
+    if (!anim->alpha_masks) {
+        fprintf(stderr, "AnimationManager: Failed to allocate alpha masks\n");
+        SDL_FreeSurface(rgba);
+        return;
+    }
+    anim->alpha_masks_flipped = anim->alpha_masks + words;
+
+    if (SDL_MUSTLOCK(rgba)) SDL_LockSurface(rgba);
+    for (int i = 0; i < anim->total_frames; i++) {
+        const SDL_Rect* rect = &anim->frames[i].rect;
+        Uint64* mask = anim->alpha_masks + (size_t)i * anim->mask_words;
+        Uint64* flipped = anim->alpha_masks_flipped + (size_t)i * anim->mask_words;
+        for (int y = 0; y < frame_h && rect->y + y < rgba->h; y++) {
+            // RGBA32 按字节顺序为 R,G,B,A，第 4 字节即 alpha
+            const Uint8* row = (const Uint8*)rgba->pixels + (size_t)(rect->y + y) * rgba->pitch + (size_t)rect->x * 4;
+            Uint64* mask_row = mask + y * anim->mask_stride;
+            Uint64* flipped_row = flipped + y * anim->mask_stride;
+            for (int x = 0; x < frame_w && rect->x + x < rgba->w; x++) {
+                if (row[x * 4 + 3] >= ALPHA_MASK_THRESHOLD) {
+                    int fx = frame_w - 1 - x;
+                    mask_row[x >> 6] |= (Uint64)1 << (x & 63);
+                    flipped_row[fx >> 6] |= (Uint64)1 << (fx & 63);
+                }
+            }
+        }
+    }
+    if (SDL_MUSTLOCK(rgba)) SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+}
+
+// 取掩码行中从 bit 开始的 64 位（越界部分为 0，bit 可为负）
+static Uint64 mask_bits_at(const Uint64* row, int stride, int bit) {
+    if (bit <= -64 || bit >= stride * 64) return 0;
+    if (bit < 0) return row[0] << (-bit);
+    int word = bit >> 6;
+    int shift = bit & 63;
+    Uint64 bits = row[word] >> shift;
+    if (shift && word + 1 < stride) bits |= row[word + 1] << (64 - shift);
+    return bits;
+}
+
+// 取帧掩码的第 y 行（已处理水平/垂直翻转）
+static const Uint64* mask_row(const Animation* anim, int frame_idx, int y, SDL_RendererFlip flip) {
+    int frame_h = anim->frames[frame_idx].rect.h;
+    const Uint64* mask = (flip & SDL_FLIP_HORIZONTAL) ? anim->alpha_masks_flipped : anim->alpha_masks;
+    int row = (flip & SDL_FLIP_VERTICAL) ? frame_h - 1 - y : y;
+    return mask + (size_t)frame_idx * anim->mask_words + (size_t)row * anim->mask_stride;
+}
+
+// 划分分块并建立 帧 -> 分块 映射
+// 整图模式：一块即 ImageManager 纹理；分块模式：每块为一行帧中不超过纹理上限的若干列
+static bool split_into_tiles(AnimationManager* manager, Animation* anim, int frame_w, int frame_h) {
+    if (anim->texture) {
+        anim->tiles = (AnimationTile*)malloc(sizeof(AnimationTile));
+        if (!anim->tiles) return false;
+        SDL_Rect whole = { 0, 0, frame_w * anim->cols, frame_h * anim->rows };
+        anim->tiles[0].area = whole;
+        anim->tiles[0].texture = anim->texture;
+        anim->tiles[0].owned = false;
+        anim->tile_count = 1;
+        anim->tiles_loaded = 1;
+        for (int i = 0; i < anim->total_frames; i++) {
+            anim->frames[i].tile = 0;
+            anim->frames[i].src = anim->frames[i].rect;
+        }
+        return true;
+    }
+
+    // 渲染器纹理尺寸上限（0 表示未报告；渲染线程模式用渲染线程查询好的值）
+    SDL_RendererInfo info;
+    int max_w = ANIMATION_TILE_MAX_SIZE;
+    int max_h = ANIMATION_TILE_MAX_SIZE;
+    if (manager->queue) {
+        if (manager->queue->max_texture_w > 0) max_w = manager->queue->max_texture_w;
+        if (manager->queue->max_texture_h > 0) max_h = manager->queue->max_texture_h;
+    } else if (manager->renderer && SDL_GetRendererInfo(manager->renderer, &info) == 0) {
+        if (info.max_texture_width > 0) max_w = info.max_texture_width;
+        if (info.max_texture_height > 0) max_h = info.max_texture_height;
+    }
+    if (frame_w > max_w || frame_h > max_h) {
+        fprintf(stderr, "AnimationManager: Frame %dx%d exceeds renderer limit %dx%d\n", frame_w, frame_h, max_w, max_h);
+        return false;
+    }
+
+    int cols_per_tile = max_w / frame_w;
+    if (cols_per_tile > anim->cols) cols_per_tile = anim->cols;
+    int tiles_per_row = (anim->cols + cols_per_tile - 1) / cols_per_tile;
+
+    anim->tiles = (AnimationTile*)calloc(anim->rows * tiles_per_row, sizeof(AnimationTile));
+    if (!anim->tiles) return false;
+    anim->tile_count = anim->rows * tiles_per_row;
+    anim->tiles_loaded = 0;
+
+    for (int row = 0; row < anim->rows; row++) {
+        for (int t = 0; t < tiles_per_row; t++) {
+            int first_col = t * cols_per_tile;
+            int tile_cols = anim->cols - first_col < cols_per_tile ? anim->cols - first_col : cols_per_tile;
+            SDL_Rect area = { first_col * frame_w, row * frame_h, tile_cols * frame_w, frame_h };
+            anim->tiles[row * tiles_per_row + t].area = area;
+        }
+        for (int col = 0; col < anim->cols; col++) {
+            AnimationFrame* frame = &anim->frames[row * anim->cols + col];
+            frame->tile = row * tiles_per_row + col / cols_per_tile;
+            frame->src = (SDL_Rect){ (col % cols_per_tile) * frame_w, 0, frame_w, frame_h };
+        }
+    }
+    return true;
+}
+
+// 解码分块模式精灵图的 RGBA32 像素（调用方负责 SDL_FreeSurface）
+static SDL_Surface* decode_sheet(const char* path) {
+    SDL_Surface* decoded = IMG_Load(path);
+    if (!decoded) {
+        fprintf(stderr, "AnimationManager: Failed to decode '%s': %s\n", path, IMG_GetError());
+        return NULL;
+    }
+    SDL_Surface* sheet = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(decoded);
+    if (!sheet) {
+        fprintf(stderr, "AnimationManager: Failed to convert sheet '%s': %s\n", path, SDL_GetError());
+    }
+    return sheet;
+}
+
+// 从解码像素上传一个分块
+static bool upload_tile(SDL_Renderer* renderer, Animation* anim, int tile_idx, SDL_Surface* sheet) {
+    AnimationTile* tile = &anim->tiles[tile_idx];
+    if (tile->texture) return true;
+    if (tile->area.x + tile->area.w > sheet->w || tile->area.y + tile->area.h > sheet->h) {
+        fprintf(stderr, "AnimationManager: Tile %d of '%s' is outside the decoded sheet\n", tile_idx, anim->texture_key);
+        return false;
+    }
+
+    Uint8* pixels = (Uint8*)sheet->pixels + (size_t)tile->area.y * sheet->pitch + (size_t)tile->area.x * 4;
+    SDL_Surface* view = SDL_CreateRGBSurfaceWithFormatFrom(
+        pixels, tile->area.w, tile->area.h, 32, sheet->pitch, SDL_PIXELFORMAT_RGBA32
+    );
+    if (view) {
+        tile->texture = SDL_CreateTextureFromSurface(renderer, view);
+        SDL_FreeSurface(view);
+    }
+    if (!tile->texture) {
+        fprintf(stderr, "AnimationManager: Failed to upload tile %d of '%s': %s\n", tile_idx, anim->texture_key, SDL_GetError());
+        return false;
+    }
+    tile->owned = true;
+    anim->tiles_loaded++;
+    printf("AnimationManager: Tile %d of '%s' uploaded (%dx%d)\n", tile_idx, anim->texture_key, tile->area.w, tile->area.h);
+    return true;
+}
+
+// 解码一次源图片，上传列出的分块中尚未上传的部分，然后释放像素
+static bool upload_tiles(AnimationManager* manager, Animation* anim, const int* tile_indices, int count) {
+    bool missing = false;
+    for (int i = 0; i < count; i++) {
+        if (tile_indices[i] < 0 || tile_indices[i] >= anim->tile_count) return false;
+        if (!anim->tiles[tile_indices[i]].texture) missing = true;
+    }
+    if (!missing) return true;
+    if (!anim->sheet_path) return false;
+
+    // 渲染线程模式下纹理只能由渲染线程创建
+    SDL_Renderer* renderer = manager->renderer;
+    if (manager->queue) {
+        if (SDL_ThreadID() != manager->queue->thread_id) {
+            fprintf(stderr, "AnimationManager: Tiles of '%s' must be uploaded on the render thread\n", anim->texture_key);
+            return false;
+        }
+        renderer = manager->queue->renderer;
+    }
+    if (!renderer) {
+        fprintf(stderr, "AnimationManager: No renderer to upload tiles of '%s'\n", anim->texture_key);
+        return false;
+    }
+
+    // 不保留整图像素：未播放的行不占内存，需要时再解码
+    SDL_Surface* sheet = decode_sheet(anim->sheet_path);
+    if (!sheet) {
+        // 源图片已不可用，不再重试
+        free(anim->sheet_path);
+        anim->sheet_path = NULL;
+        return false;
+    }
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        ok = upload_tile(renderer, anim, tile_indices[i], sheet) && ok;
+    }
+    SDL_FreeSurface(sheet);
+    return ok;
+}
 
-    // 获取纹理尺寸
+// 释放动画对象及其序列、分块和掩码
+static void free_animation(Animation* anim) {
+    for (int j = 0; j < anim->clip_count; j++) {
+        free(anim->clips[j]->name);
+        free(anim->clips[j]->frame_indices);
+        free(anim->clips[j]);
+    }
+    for (int j = 0; j < anim->anchor_count; j++) {
+        free(anim->anchors[j].name);
+        free(anim->anchors[j].points);
+    }
+    free(anim->anchors);
+    for (int t = 0; t < anim->tile_count; t++) {
+        if (anim->tiles[t].owned && anim->tiles[t].texture) SDL_DestroyTexture(anim->tiles[t].texture);
+    }
+    free(anim->sheet_path);
+    free(anim->tiles);
+    free(anim->clips);
+    free(anim->frames);
+    free(anim->alpha_masks);
+    free(anim->texture_key);
+    free(anim);
+}
+
+// 渲染线程任务：引用该动画的帧已执行完，释放展开纹理和动画
+static void destroy_animation_task(RenderQueue* queue, void* data) {
+    Animation* anim = (Animation*)data;
+    PaletteManager_ForgetAnimation(queue->anim_manager->palettes, anim);
+    free_animation(anim);
+}
+
+// 计算精灵图单帧矩形、分块映射，并从源图片生成每帧 Alpha 掩码
+// sheet 为分块模式加载时解码的像素（只用于尺寸和掩码）
+static bool calculate_frame_rects(AnimationManager* manager, Animation* anim, const char* texture_key, SDL_Surface* sheet) {
+    if (!anim || (!anim->texture && !sheet && !anim->index_sheet)) return false;
+
+    // 获取精灵图尺寸（分块/索引模式取像素的尺寸）
     int tex_w, tex_h;
-    SDL_QueryTexture(anim->texture, NULL, NULL, &tex_w, &tex_h);
+    if (anim->texture) {
+        SDL_QueryTexture(anim->texture, NULL, NULL, &tex_w, &tex_h);
+    } else if (anim->index_sheet) {
+        tex_w = anim->index_sheet->w;
+        tex_h = anim->index_sheet->h;
+    } else {
+        tex_w = sheet->w;
+        tex_h = sheet->h;
+    }
 
     // 计算单帧尺寸
     int frame_w = tex_w / anim->cols;
     int frame_h = tex_h / anim->rows;
+    if (frame_w <= 0 || frame_h <= 0) {
+        fprintf(stderr, "AnimationManager: Sheet '%s' (%dx%d) too small for %d rows x %d cols\n", texture_key, tex_w, tex_h, anim->rows, anim->cols);
+        return false;
+    }
 
     // 缓存所有帧的矩形
     anim->total_frames = anim->rows * anim->cols;
     anim->frames = (AnimationFrame*)malloc(sizeof(AnimationFrame) * anim->total_frames);
     if (!anim->frames) {
         fprintf(stderr, "AnimationManager: Failed to allocate frames\n");
-        return;
+        return false;
     }
 
     for (int row = 0; row < anim->rows; row++) {
@@ -55,12 +307,31 @@ static void calculate_frame_rects(Animation* anim) {
             };
         }
     }
+
+    if (!split_into_tiles(manager, anim, frame_w, frame_h)) {
+        fprintf(stderr, "AnimationManager: Failed to split '%s' into tiles\n", texture_key);
+        return false;
+    }
+
+    // 掩码只在加载时生成一次，命中/碰撞检测不再回读纹理
+    if (sheet) {
+        build_alpha_masks(anim, sheet);
+    } else if (anim->index_sheet) {
+        build_alpha_masks(anim, anim->index_sheet);
+    } else {
+        SDL_Surface* surface = ImageManager_LoadSurface(manager->img_manager, texture_key);
+        if (surface) {
+            build_alpha_masks(anim, surface);
+            SDL_FreeSurface(surface);
+        }
+    }
+    return true;
 }
 
 // ========== 核心接口实现 ==========
 AnimationManager* AnimationManager_Create(ImageManager* img_manager, SDL_Renderer* renderer) {
-    if (!img_manager || !renderer) {
-        fprintf(stderr, "AnimationManager: Invalid img_manager or renderer\n");
+    if (!img_manager) {
+        fprintf(stderr, "AnimationManager: Invalid img_manager\n");
         return NULL;
     }
 
@@ -74,6 +345,13 @@ AnimationManager* AnimationManager_Create(ImageManager* img_manager, SDL_Rendere
     manager->animation_count = 0;
     manager->img_manager = img_manager;
     manager->renderer = renderer;
+    manager->stats = RenderStats_GetInstance();
+    manager->queue = NULL;
+    manager->palettes = PaletteManager_Create(renderer);
+    if (!manager->palettes) {
+        free(manager);
+        return NULL;
+    }
 
     return manager;
 }
@@ -96,17 +374,28 @@ Animation* AnimationManager_LoadAnimation(
         return find_animation(manager, anim_key);
     }
 
-    // 从 ImageManager 获取纹理
+    // 从 ImageManager 获取纹理；RegisterSheet 注册的大图没有整图纹理，改为解码后分块
+    // LoadIndexed 加载的索引图直接共享索引像素
     SDL_Texture* texture = ImageManager_GetTexture(manager->img_manager, texture_key);
-    if (!texture) {
-        fprintf(stderr, "AnimationManager: Texture '%s' not found in ImageManager\n", texture_key);
-        return NULL;
+    SDL_Surface* index_sheet = texture ? NULL : ImageManager_GetIndexed(manager->img_manager, texture_key);
+    // 分块模式：加载时解码一次取尺寸和掩码，之后只保留路径，上传分块时再解码
+    const char* sheet_path = NULL;
+    SDL_Surface* sheet = NULL;
+    if (!texture && !index_sheet) {
+        sheet_path = ImageManager_GetPath(manager->img_manager, texture_key);
+        if (!sheet_path) {
+            fprintf(stderr, "AnimationManager: Texture '%s' not found in ImageManager\n", texture_key);
+            return NULL;
+        }
+        sheet = decode_sheet(sheet_path);
+        if (!sheet) return NULL;
     }
 
     // 创建动画对象
     Animation* anim = (Animation*)malloc(sizeof(Animation));
     if (!anim) {
         fprintf(stderr, "AnimationManager: Failed to allocate animation\n");
+        if (sheet) SDL_FreeSurface(sheet);
         return NULL;
     }
 
@@ -117,8 +406,26 @@ Animation* AnimationManager_LoadAnimation(
     anim->cols = cols;
     anim->total_frames = 0;
     anim->frames = NULL;
+    anim->tiles = NULL;
+    anim->tile_count = 0;
+    anim->tiles_loaded = 0;
+    anim->sheet_path = NULL;
+    if (sheet_path) {
+        anim->sheet_path = (char*)malloc(strlen(sheet_path) + 1);
+        if (anim->sheet_path) strcpy(anim->sheet_path, sheet_path);
+    }
+    anim->index_sheet = index_sheet;
+    anim->default_palette = NULL;
+    anim->palette = NULL;
+    anim->transparent_index = -1;
+    anim->alpha_masks = NULL;
+    anim->alpha_masks_flipped = NULL;
+    anim->mask_stride = 0;
+    anim->mask_words = 0;
     anim->clips = NULL;
     anim->clip_count = 0;
+    anim->anchors = NULL;
+    anim->anchor_count = 0;
     anim->current_clip = NULL;
     anim->elapsed_time = 0.0f;
     anim->current_index = 0;
@@ -126,7 +433,24 @@ Animation* AnimationManager_LoadAnimation(
     anim->speed = 1.0f;
 
     // 计算帧矩形
-    calculate_frame_rects(anim);
+    bool computed = calculate_frame_rects(manager, anim, texture_key, sheet);
+    if (sheet) SDL_FreeSurface(sheet);
+    if (!computed) {
+        free_animation(anim);
+        return NULL;
+    }
+
+    // 索引模式：精灵图自带调色板以 anim_key 登记，作为默认调色板
+    if (index_sheet) {
+        const SDL_Palette* sheet_palette = index_sheet->format->palette;
+        Uint32 key;
+        if (SDL_GetColorKey(index_sheet, &key) == 0) anim->transparent_index = (int)key;
+        anim->default_palette = PaletteManager_AddPalette(manager->palettes, anim_key, sheet_palette->colors, sheet_palette->ncolors);
+        if (!anim->default_palette) {
+            free_animation(anim);
+            return NULL;
+        }
+    }
 
     // 添加到管理器
     manager->animations = (Animation**)realloc(
@@ -135,7 +459,7 @@ Animation* AnimationManager_LoadAnimation(
     );
     manager->animations[manager->animation_count++] = anim;
 
-    printf("AnimationManager: Animation '%s' loaded (rows: %d, cols: %d)\n", anim_key, rows, cols);
+    printf("AnimationManager: Animation '%s' loaded (rows: %d, cols: %d, tiles: %d)\n", anim_key, rows, cols, anim->tile_count);
     return anim;
 }
 
@@ -194,6 +518,59 @@ bool AnimationManager_AddClip(
     return true;
 }
 
+int AnimationManager_AddAnchor(Animation* anim, const char* anchor_name) {
+    if (!anim || !anim->frames || !anchor_name) {
+        fprintf(stderr, "AnimationManager: Invalid params for AddAnchor\n");
+        return -1;
+    }
+
+    int existing = AnimationManager_FindAnchor(anim, anchor_name);
+    if (existing >= 0) return existing;
+
+    AnimationAnchor* anchors = (AnimationAnchor*)realloc(anim->anchors, sizeof(AnimationAnchor) * (anim->anchor_count + 1));
+    if (!anchors) {
+        fprintf(stderr, "AnimationManager: Failed to allocate anchor\n");
+        return -1;
+    }
+    anim->anchors = anchors;
+
+    AnimationAnchor* anchor = &anim->anchors[anim->anchor_count];
+    anchor->name = (char*)malloc(strlen(anchor_name) + 1);
+    anchor->points = (SDL_FPoint*)malloc(sizeof(SDL_FPoint) * anim->total_frames);
+    if (!anchor->name || !anchor->points) {
+        fprintf(stderr, "AnimationManager: Failed to allocate anchor\n");
+        free(anchor->name);
+        free(anchor->points);
+        return -1;
+    }
+    strcpy(anchor->name, anchor_name);
+    for (int i = 0; i < anim->total_frames; i++) {
+        anchor->points[i].x = anim->frames[i].rect.w / 2.0f;
+        anchor->points[i].y = anim->frames[i].rect.h / 2.0f;
+    }
+
+    printf("AnimationManager: Anchor '%s' added to animation\n", anchor_name);
+    return anim->anchor_count++;
+}
+
+bool AnimationManager_SetAnchor(Animation* anim, int anchor, int frame_idx, float x, float y) {
+    if (!anim || anchor < 0 || anchor >= anim->anchor_count || frame_idx < 0 || frame_idx >= anim->total_frames) {
+        fprintf(stderr, "AnimationManager: Invalid params for SetAnchor\n");
+        return false;
+    }
+    anim->anchors[anchor].points[frame_idx].x = x;
+    anim->anchors[anchor].points[frame_idx].y = y;
+    return true;
+}
+
+int AnimationManager_FindAnchor(const Animation* anim, const char* anchor_name) {
+    if (!anim || !anchor_name) return -1;
+    for (int i = 0; i < anim->anchor_count; i++) {
+        if (strcmp(anim->anchors[i].name, anchor_name) == 0) return i;
+    }
+    return -1;
+}
+
 void AnimationManager_Update(AnimationManager* manager, float dt) {
     if (!manager || dt <= 0) return;
 
@@ -255,9 +632,10 @@ void AnimationManager_Draw(
     AnimationClip* clip = find_clip(anim, anim->current_clip);
     if (!clip || anim->current_index >= clip->frame_count) return;
 
-    // 获取当前帧索引和矩形
+    // 获取当前帧索引、所在分块和矩形
     int frame_idx = clip->frame_indices[anim->current_index];
-    SDL_Rect* src_rect = &anim->frames[frame_idx].rect;
+    const AnimationFrame* frame = &anim->frames[frame_idx];
+    const SDL_Rect* src_rect = &frame->src;
 
     // 计算绘制尺寸
     SDL_Rect dst_rect;
@@ -271,16 +649,63 @@ void AnimationManager_Draw(
     dst_rect.x = x - dst_rect.w / 2; // 居中绘制
     dst_rect.y = y - dst_rect.h / 2;
 
+    // 使用渲染线程时只录制命令（分块纹理归渲染线程所有，这里不读取）
+    if (manager->queue) {
+        RenderQueue_Push(manager->queue, anim, frame->tile, anim->palette, src_rect, &dst_rect, rotation * 180 / M_PI, flip);
+        RenderStats_RecordDraw(manager->stats, &anim->tiles[frame->tile], &dst_rect);
+        return;
+    }
+
+    // 索引模式：按调色板解析颜色
+    if (anim->index_sheet) {
+        PaletteManager_Draw(manager->palettes, anim, frame->tile, anim->palette, src_rect, &dst_rect, rotation * 180 / M_PI, flip);
+        RenderStats_RecordDraw(manager->stats, &anim->tiles[frame->tile], &dst_rect);
+        return;
+    }
+
+    SDL_Texture* texture = anim->tiles[frame->tile].texture;
+    if (!texture) return;
+
     // 绘制
     SDL_RenderCopyEx(
         manager->renderer,
-        anim->texture,
+        texture,
         src_rect,
         &dst_rect,
         rotation * 180 / M_PI, // 转角度
         NULL,                  // 旋转中心（居中）
         flip
     );
+    RenderStats_RecordDraw(manager->stats, texture, &dst_rect);
+}
+
+bool AnimationManager_PrepareClip(AnimationManager* manager, Animation* anim, const AnimationClip* clip) {
+    if (!manager || !anim || !clip) return false;
+    if (manager->queue) return true; // 渲染线程首次绘制时上传
+    if (anim->index_sheet) return true; // 索引模式由 PaletteManager 按需展开
+
+    // 序列用到的分块一起上传，只解码一次
+    int* tile_indices = (int*)malloc(sizeof(int) * clip->frame_count);
+    if (!tile_indices) {
+        fprintf(stderr, "AnimationManager: Failed to allocate tile list\n");
+        return false;
+    }
+    for (int i = 0; i < clip->frame_count; i++) {
+        tile_indices[i] = anim->frames[clip->frame_indices[i]].tile;
+    }
+    bool ok = upload_tiles(manager, anim, tile_indices, clip->frame_count);
+    free(tile_indices);
+    return ok;
+}
+
+bool AnimationManager_UploadTile(AnimationManager* manager, Animation* anim, int tile_idx) {
+    if (!manager || !anim) return false;
+    return upload_tiles(manager, anim, &tile_idx, 1);
+}
+
+bool AnimationManager_UploadTiles(AnimationManager* manager, Animation* anim, const int* tile_indices, int count) {
+    if (!manager || !anim || (!tile_indices && count > 0)) return false;
+    return upload_tiles(manager, anim, tile_indices, count);
 }
 
 void AnimationManager_Play(AnimationManager* manager, const char* anim_key, const char* clip_name) {
@@ -298,6 +723,9 @@ void AnimationManager_Play(AnimationManager* manager, const char* anim_key, cons
         return;
     }
 
+    // 首次播放时上传序列用到的分块
+    AnimationManager_PrepareClip(manager, anim, clip);
+
     // 重置播放状态
     anim->current_clip = clip->name;
     anim->elapsed_time = 0.0f;
@@ -328,6 +756,60 @@ void AnimationManager_SetSpeed(AnimationManager* manager, const char* anim_key,
     if (anim) anim->speed = speed;
 }
 
+void AnimationManager_SetPalette(AnimationManager* manager, const char* anim_key, struct SpritePalette* palette) {
+    if (!manager || !anim_key) return;
+
+    Animation* anim = find_animation(manager, anim_key);
+    if (!anim) return;
+    if (!anim->index_sheet) {
+        fprintf(stderr, "AnimationManager: Animation '%s' is not indexed, palette ignored\n", anim_key);
+        return;
+    }
+    anim->palette = palette;
+}
+
+bool AnimationManager_FrameHitTest(const Animation* anim, int frame_idx, int local_x, int local_y, SDL_RendererFlip flip) {
+    if (!anim || !anim->alpha_masks || frame_idx < 0 || frame_idx >= anim->total_frames) return false;
+
+    const SDL_Rect* rect = &anim->frames[frame_idx].rect;
+    if (local_x < 0 || local_y < 0 || local_x >= rect->w || local_y >= rect->h) return false;
+
+    const Uint64* row = mask_row(anim, frame_idx, local_y, flip);
+    return (row[local_x >> 6] >> (local_x & 63)) & 1;
+}
+
+bool AnimationManager_FrameOverlap(
+    const Animation* a, int frame_a, SDL_RendererFlip flip_a,
+    const Animation* b, int frame_b, SDL_RendererFlip flip_b,
+    int dx, int dy
+) {
+    if (!a || !b || !a->alpha_masks || !b->alpha_masks) return false;
+    if (frame_a < 0 || frame_a >= a->total_frames || frame_b < 0 || frame_b >= b->total_frames) return false;
+
+    const SDL_Rect* ra = &a->frames[frame_a].rect;
+    const SDL_Rect* rb = &b->frames[frame_b].rect;
+
+    // 重叠区域（帧 a 坐标系）
+    int x0 = dx > 0 ? dx : 0;
+    int y0 = dy > 0 ? dy : 0;
+    int x1 = dx + rb->w < ra->w ? dx + rb->w : ra->w;
+    int y1 = dy + rb->h < ra->h ? dy + rb->h : ra->h;
+    if (x1 <= x0 || y1 <= y0) return false;
+
+    // 逐行按 64 位字做 AND：a 的一个字对应 b 中错开 dx 位的 64 位
+    // 区域外的位在 a 中是行尾补 0，在 b 中由 mask_bits_at 补 0，无需额外掩码
+    int word0 = x0 >> 6;
+    int word1 = (x1 - 1) >> 6;
+    for (int y = y0; y < y1; y++) {
+        const Uint64* row_a = mask_row(a, frame_a, y, flip_a);
+        const Uint64* row_b = mask_row(b, frame_b, y - dy, flip_b);
+        for (int w = word0; w <= word1; w++) {
+            if (row_a[w] & mask_bits_at(row_b, b->mask_stride, w * 64 - dx)) return true;
+        }
+    }
+    return false;
+}
+
 void AnimationManager_DestroyAnimation(AnimationManager* manager, const char* anim_key) {
     if (!manager || !anim_key) return;
 
@@ -335,16 +817,14 @@ void AnimationManager_DestroyAnimation(AnimationManager* manager, const char* an
     for (int i = 0; i < manager->animation_count; i++) {
         Animation* anim = manager->animations[i];
         if (strcmp(anim->texture_key, anim_key) == 0) {
-            // 释放序列
-            for (int j = 0; j < anim->clip_count; j++) {
-                free(anim->clips[j]->name);
-                free(anim->clips[j]->frame_indices);
-                free(anim->clips[j]);
+            // 释放展开纹理、序列、分块和掩码
+            // 渲染线程模式下已录制的命令和展开缓存还引用它，排到本帧之后由渲染线程释放
+            if (manager->queue) {
+                RenderQueue_Defer(manager->queue, destroy_animation_task, anim);
+            } else {
+                PaletteManager_ForgetAnimation(manager->palettes, anim);
+                free_animation(anim);
             }
-            free(anim->clips);
-            free(anim->frames);
-            free(anim->texture_key);
-            free(anim);
 
             // 移除数组
             for (int j = i; j < manager->animation_count - 1; j++) {
@@ -362,23 +842,37 @@ void AnimationManager_DestroyAnimation(AnimationManager* manager, const char* an
     }
 }
 
-void AnimationManager_Destroy(AnimationManager* manager) {
+void AnimationManager_ReleaseTextures(AnimationManager* manager) {
     if (!manager) return;
 
-    // 销毁所有动画
+    PaletteManager_ReleaseTextures(manager->palettes);
     for (int i = 0; i < manager->animation_count; i++) {
         Animation* anim = manager->animations[i];
-        for (int j = 0; j < anim->clip_count; j++) {
-            free(anim->clips[j]->name);
-            free(anim->clips[j]->frame_indices);
-            free(anim->clips[j]);
+        for (int t = 0; t < anim->tile_count; t++) {
+            AnimationTile* tile = &anim->tiles[t];
+            if (!tile->owned || !tile->texture) continue;
+            SDL_DestroyTexture(tile->texture);
+            tile->texture = NULL;
+            tile->owned = false;
+            anim->tiles_loaded--;
         }
-        free(anim->clips);
-        free(anim->frames);
-        free(anim->texture_key);
-        free(anim);
+    }
+}
+
+void AnimationManager_Destroy(AnimationManager* manager) {
+    if (!manager) return;
+    if (manager->queue) {
+        // 分块纹理归渲染线程所有，须先由 RenderQueue_Destroy 释放
+        fprintf(stderr, "AnimationManager: Destroy the RenderQueue before the AnimationManager\n");
+        return;
+    }
+
+    // 销毁所有动画
+    for (int i = 0; i < manager->animation_count; i++) {
+        free_animation(manager->animations[i]);
     }
 
+    PaletteManager_Destroy(manager->palettes);
     free(manager->animations);
     free(manager);
 
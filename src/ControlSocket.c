@@ -0,0 +1,361 @@
+#include "ControlSocket.h"
+
+#if defined(_WIN32) || defined(WIN32)
+
+// Windows 暂不支持（AF_UNIX 需要 Winsock 初始化，覆盖层伴随进程目前只在 Linux/macOS 上运行）
+ControlSocket* ControlSocket_Create(const char* path) {
+    (void)path;
+    fprintf(stderr, "ControlSocket: Not supported on Windows\n");
+    return NULL;
+}
+
+ControlSocket* ControlSocket_CreateReplay(FrameRecorder* recorder) {
+    (void)recorder;
+    return NULL; // Windows 上无法录制控制命令，日志中也不会有
+}
+
+void ControlSocket_AttachRecorder(ControlSocket* control, FrameRecorder* recorder) {
+    (void)control; (void)recorder;
+}
+
+int ControlSocket_Service(ControlSocket* control, ImageManager* img_manager, SpriteStore* store, RenderStats* stats) {
+    (void)control; (void)img_manager; (void)store; (void)stats;
+    return 0;
+}
+
+void ControlSocket_Destroy(ControlSocket* control) {
+    (void)control;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifdef MSG_NOSIGNAL
+    #define CONTROL_SEND_FLAGS MSG_NOSIGNAL
+#else
+    #define CONTROL_SEND_FLAGS 0
+#endif
+
+// ========== 内部辅助函数 ==========
+static bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void close_client(ControlSocket* control, int i) {
+    close(control->clients[i].fd);
+    control->clients[i] = control->clients[--control->client_count];
+}
+
+// 接受所有等待中的连接
+static void accept_clients(ControlSocket* control) {
+    for (;;) {
+        int fd = accept(control->listen_fd, NULL, NULL);
+        if (fd < 0) return; // EAGAIN：没有更多连接
+
+        if (control->client_count >= CONTROL_MAX_CLIENTS || !set_nonblocking(fd)) {
+            fprintf(stderr, "ControlSocket: Rejecting client (max %d)\n", CONTROL_MAX_CLIENTS);
+            close(fd);
+            continue;
+        }
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        ControlClient* client = &control->clients[control->client_count++];
+        client->fd = fd;
+        client->buffered = 0;
+    }
+}
+
+// 读取客户端数据到缓冲（连接关闭或出错返回 false）
+static bool read_client(ControlClient* client) {
+    while (client->buffered < CONTROL_RECV_BUFFER) {
+        ssize_t n = recv(client->fd, client->buffer + client->buffered, CONTROL_RECV_BUFFER - client->buffered, 0);
+        if (n > 0) {
+            client->buffered += (int)n;
+        } else if (n == 0) {
+            return false;
+        } else {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+    }
+    return true;
+}
+
+// 发送全部字节；发送缓冲满或出错返回 false（不在帧循环中等待）
+static bool send_all(int fd, const Uint8* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, CONTROL_SEND_FLAGS);
+        if (n > 0) {
+            data += n;
+            length -= (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 回复统计；没能完整发出时返回 false，由调用方断开客户端（避免对方读到半条消息后错位）
+static bool send_stats(ControlClient* client, SpriteStore* store, RenderStats* stats) {
+    Uint8 reply[sizeof(ControlHeader) + sizeof(ControlStatsReply)];
+    ControlHeader header = { CONTROL_OP_QUERY_STATS, 0, sizeof(ControlStatsReply) };
+    ControlStatsReply body;
+    memset(&body, 0, sizeof(body));
+
+    body.entity_count = store ? (Uint32)store->count : 0;
+    const RenderFrameStats* frame = RenderStats_GetLastFrame(stats);
+    if (frame) {
+        body.draw_calls = frame->draw_calls;
+        body.texture_switches = frame->texture_switches;
+        body.sprites = frame->sprites;
+        body.overdraw = frame->overdraw;
+    }
+
+    memcpy(reply, &header, sizeof(header));
+    memcpy(reply + sizeof(header), &body, sizeof(body));
+    if (!send_all(client->fd, reply, sizeof(reply))) {
+        fprintf(stderr, "ControlSocket: Failed to send stats reply, dropping client\n");
+        return false;
+    }
+    return true;
+}
+
+// 执行一条命令（payload 长度已校验不超过 CONTROL_MAX_PAYLOAD；client 为 NULL 表示回放）
+// 返回 false 表示客户端需要断开
+static bool apply_command(ControlClient* client, const ControlHeader* header, const Uint8* payload,
+                          ImageManager* img_manager, SpriteStore* store, RenderStats* stats) {
+    char text[CONTROL_MAX_PAYLOAD + 1];
+    Uint32 entity = 0;
+    float values[2];
+
+    switch (header->opcode) {
+        case CONTROL_OP_PLAY_CLIP:
+            if (header->length <= sizeof(Uint32)) break;
+            memcpy(&entity, payload, sizeof(entity));
+            memcpy(text, payload + sizeof(entity), header->length - sizeof(entity));
+            text[header->length - sizeof(entity)] = '\0';
+            SpriteStore_Play(store, entity, text);
+            return true;
+        case CONTROL_OP_SET_SPEED:
+            if (header->length != sizeof(Uint32) + sizeof(float)) break;
+            memcpy(&entity, payload, sizeof(entity));
+            memcpy(values, payload + sizeof(entity), sizeof(float));
+            SpriteStore_SetSpeed(store, entity, values[0]);
+            return true;
+        case CONTROL_OP_MOVE:
+            if (header->length != sizeof(Uint32) + sizeof(float) * 2) break;
+            memcpy(&entity, payload, sizeof(entity));
+            memcpy(values, payload + sizeof(entity), sizeof(float) * 2);
+            SpriteStore_SetPosition(store, entity, values[0], values[1]);
+            return true;
+        case CONTROL_OP_LOAD_TEXTURE: {
+            Uint16 key_len = 0;
+            if (header->length < sizeof(Uint16)) break;
+            memcpy(&key_len, payload, sizeof(key_len));
+            int path_len = header->length - (int)sizeof(Uint16) - key_len;
+            if (key_len == 0 || path_len <= 0) break;
+            // key 和路径共用缓冲：key\0path\0
+            memcpy(text, payload + sizeof(Uint16), header->length - sizeof(Uint16));
+            memmove(text + key_len + 1, text + key_len, path_len);
+            text[key_len] = '\0';
+            text[key_len + 1 + path_len] = '\0';
+            // 只登记路径，不在此处创建纹理（渲染器可能归渲染线程所有）
+            ImageManager_RegisterSheet(img_manager, text, text + key_len + 1);
+            return true;
+        }
+        case CONTROL_OP_QUERY_STATS:
+            return !client || send_stats(client, store, stats);
+        default:
+            break;
+    }
+    fprintf(stderr, "ControlSocket: Malformed command (op: %d, length: %d)\n", header->opcode, header->length);
+    return true;
+}
+
+// 回放：执行日志中当前帧录制的命令
+static int replay_commands(ControlSocket* control, ImageManager* img_manager, SpriteStore* store, RenderStats* stats) {
+    int length = 0;
+    const Uint8* data = FrameRecorder_GetCommands(control->recorder, &length);
+    int offset = 0;
+    int executed = 0;
+    while (length - offset >= (int)sizeof(ControlHeader)) {
+        ControlHeader header;
+        memcpy(&header, data + offset, sizeof(header));
+        if (header.length > CONTROL_MAX_PAYLOAD || length - offset - (int)sizeof(header) < header.length) {
+            fprintf(stderr, "ControlSocket: Corrupt command in replay log\n");
+            break;
+        }
+        apply_command(NULL, &header, data + offset + sizeof(header), img_manager, store, stats);
+        offset += (int)sizeof(header) + header.length;
+        executed++;
+    }
+    return executed;
+}
+
+// ========== 核心接口实现 ==========
+ControlSocket* ControlSocket_Create(const char* path) {
+    struct sockaddr_un addr;
+    if (!path || strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "ControlSocket: Invalid socket path\n");
+        return NULL;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "ControlSocket: socket() failed: %s\n", strerror(errno));
+        return NULL;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, CONTROL_MAX_CLIENTS) != 0 || !set_nonblocking(fd)) {
+        fprintf(stderr, "ControlSocket: Failed to listen on '%s': %s\n", path, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    ControlSocket* control = (ControlSocket*)malloc(sizeof(ControlSocket));
+    if (!control) {
+        fprintf(stderr, "ControlSocket: Failed to allocate control socket\n");
+        close(fd);
+        unlink(path);
+        return NULL;
+    }
+    control->listen_fd = fd;
+    control->path = (char*)malloc(strlen(path) + 1);
+    strcpy(control->path, path);
+    control->client_count = 0;
+    control->recorder = NULL;
+
+    printf("ControlSocket: Listening on '%s'\n", path);
+    return control;
+}
+
+ControlSocket* ControlSocket_CreateReplay(FrameRecorder* recorder) {
+    if (!recorder || recorder->mode != FRAME_RECORDER_REPLAY) {
+        fprintf(stderr, "ControlSocket: Invalid replay recorder\n");
+        return NULL;
+    }
+
+    ControlSocket* control = (ControlSocket*)malloc(sizeof(ControlSocket));
+    if (!control) {
+        fprintf(stderr, "ControlSocket: Failed to allocate control socket\n");
+        return NULL;
+    }
+    control->listen_fd = -1;
+    control->path = NULL;
+    control->client_count = 0;
+    control->recorder = recorder;
+
+    printf("ControlSocket: Replaying recorded commands\n");
+    return control;
+}
+
+void ControlSocket_AttachRecorder(ControlSocket* control, FrameRecorder* recorder) {
+    if (!control || control->listen_fd < 0) return;
+    control->recorder = (recorder && recorder->mode == FRAME_RECORDER_RECORD) ? recorder : NULL;
+}
+
+int ControlSocket_Service(ControlSocket* control, ImageManager* img_manager, SpriteStore* store, RenderStats* stats) {
+    if (!control) return 0;
+    if (control->listen_fd < 0) return replay_commands(control, img_manager, store, stats);
+
+    // 零超时 poll：只处理已就绪的描述符，不阻塞帧循环
+    struct pollfd fds[CONTROL_MAX_CLIENTS + 1];
+    fds[0].fd = control->listen_fd;
+    fds[0].events = POLLIN;
+    for (int i = 0; i < control->client_count; i++) {
+        fds[i + 1].fd = control->clients[i].fd;
+        fds[i + 1].events = POLLIN;
+    }
+    int client_count = control->client_count;
+    if (poll(fds, client_count + 1, 0) > 0) {
+        // 先读数据（倒序遍历，关闭连接时 swap-remove 不影响未处理的下标）
+        for (int i = client_count - 1; i >= 0; i--) {
+            if (fds[i + 1].revents && !read_client(&control->clients[i])) {
+                close_client(control, i);
+            }
+        }
+        // 新连接立即尝试读取，首条命令不必多等一帧
+        if (fds[0].revents & POLLIN) {
+            int first_new = control->client_count;
+            accept_clients(control);
+            for (int i = control->client_count - 1; i >= first_new; i--) {
+                if (!read_client(&control->clients[i])) close_client(control, i);
+            }
+        }
+    }
+
+    // 再批量执行所有完整命令（包括上一帧因数量上限留下的）
+    int executed = 0;
+    for (int i = control->client_count - 1; i >= 0; i--) {
+        ControlClient* client = &control->clients[i];
+        int offset = 0;
+        bool broken = false;
+
+        while (executed < CONTROL_MAX_COMMANDS_PER_FRAME && client->buffered - offset >= (int)sizeof(ControlHeader)) {
+            ControlHeader header;
+            memcpy(&header, client->buffer + offset, sizeof(header));
+            if (header.length > CONTROL_MAX_PAYLOAD) {
+                fprintf(stderr, "ControlSocket: Payload too large (%d), dropping client\n", header.length);
+                broken = true;
+                break;
+            }
+            if (client->buffered - offset < (int)sizeof(header) + header.length) break; // 不完整，等下一帧
+
+            const Uint8* message = client->buffer + offset;
+            if (!apply_command(client, &header, message + sizeof(header), img_manager, store, stats)) {
+                broken = true;
+                break;
+            }
+            // 录制时保存原始消息，回放在同一帧重放（查询不改变状态，不录）
+            if (control->recorder && header.opcode != CONTROL_OP_QUERY_STATS) {
+                FrameRecorder_PushCommand(control->recorder, message, (int)sizeof(header) + header.length);
+            }
+            offset += (int)sizeof(header) + header.length;
+            executed++;
+        }
+
+        if (broken) {
+            close_client(control, i);
+            continue;
+        }
+        // 剩余的不完整数据移到缓冲开头
+        if (offset > 0) {
+            memmove(client->buffer, client->buffer + offset, client->buffered - offset);
+            client->buffered -= offset;
+        }
+    }
+    return executed;
+}
+
+void ControlSocket_Destroy(ControlSocket* control) {
+    if (!control) return;
+
+    for (int i = 0; i < control->client_count; i++) {
+        close(control->clients[i].fd);
+    }
+    if (control->listen_fd >= 0) {
+        close(control->listen_fd);
+        unlink(control->path);
+    }
+    free(control->path);
+    free(control);
+
+    printf("ControlSocket: Destroyed\n");
+}
+
+#endif
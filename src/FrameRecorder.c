@@ -0,0 +1,212 @@
+#include "FrameRecorder.h"
+
+// ========== 内部辅助函数 ==========
+// 判断事件能否安全回放（携带指针的事件在回放时指针已失效）
+static bool is_replayable_event(const SDL_Event* event) {
+    switch (event->type) {
+        case SDL_DROPFILE:
+        case SDL_DROPTEXT:
+        case SDL_SYSWMEVENT:
+            return false;
+        default:
+            return event->type < SDL_USEREVENT;
+    }
+}
+
+// 确保事件缓冲容量足够
+static bool reserve_events(FrameRecorder* recorder, int count) {
+    if (count <= recorder->event_capacity) return true;
+
+    int capacity = recorder->event_capacity ? recorder->event_capacity : 16;
+    while (capacity < count) capacity *= 2;
+
+    SDL_Event* events = (SDL_Event*)realloc(recorder->events, sizeof(SDL_Event) * capacity);
+    if (!events) {
+        fprintf(stderr, "FrameRecorder: Failed to allocate event buffer\n");
+        return false;
+    }
+    recorder->events = events;
+    recorder->event_capacity = capacity;
+    return true;
+}
+
+// 确保控制命令缓冲容量足够
+static bool reserve_commands(FrameRecorder* recorder, int bytes) {
+    if (bytes <= recorder->command_capacity) return true;
+
+    int capacity = recorder->command_capacity ? recorder->command_capacity : 256;
+    while (capacity < bytes) capacity *= 2;
+
+    Uint8* commands = (Uint8*)realloc(recorder->commands, capacity);
+    if (!commands) {
+        fprintf(stderr, "FrameRecorder: Failed to allocate command buffer\n");
+        return false;
+    }
+    recorder->commands = commands;
+    recorder->command_capacity = capacity;
+    return true;
+}
+
+// ========== 核心接口实现 ==========
+FrameRecorder* FrameRecorder_Open(const char* file_path, FrameRecorderMode mode) {
+    if (!file_path) {
+        fprintf(stderr, "FrameRecorder: Invalid params for Open\n");
+        return NULL;
+    }
+
+    FILE* file = fopen(file_path, mode == FRAME_RECORDER_RECORD ? "wb" : "rb");
+    if (!file) {
+        fprintf(stderr, "FrameRecorder: Failed to open '%s'\n", file_path);
+        return NULL;
+    }
+
+    // 写入或校验文件头
+    char magic[4];
+    Uint32 version = FRAME_RECORDER_VERSION;
+    if (mode == FRAME_RECORDER_RECORD) {
+        if (fwrite(FRAME_RECORDER_MAGIC, 1, 4, file) != 4 ||
+            fwrite(&version, sizeof(version), 1, file) != 1) {
+            fprintf(stderr, "FrameRecorder: Failed to write header to '%s'\n", file_path);
+            fclose(file);
+            return NULL;
+        }
+    } else {
+        if (fread(magic, 1, 4, file) != 4 || memcmp(magic, FRAME_RECORDER_MAGIC, 4) != 0 ||
+            fread(&version, sizeof(version), 1, file) != 1 || version != FRAME_RECORDER_VERSION) {
+            fprintf(stderr, "FrameRecorder: '%s' is not a valid replay log\n", file_path);
+            fclose(file);
+            return NULL;
+        }
+    }
+
+    FrameRecorder* recorder = (FrameRecorder*)malloc(sizeof(FrameRecorder));
+    if (!recorder) {
+        fprintf(stderr, "FrameRecorder: Failed to allocate recorder\n");
+        fclose(file);
+        return NULL;
+    }
+
+    recorder->file = file;
+    recorder->mode = mode;
+    recorder->frame_count = 0;
+    recorder->events = NULL;
+    recorder->event_count = 0;
+    recorder->event_capacity = 0;
+    recorder->commands = NULL;
+    recorder->command_bytes = 0;
+    recorder->command_capacity = 0;
+    recorder->total_ms = 0.0;
+    recorder->min_ms = 0.0;
+    recorder->max_ms = 0.0;
+
+    printf("FrameRecorder: %s '%s'\n", mode == FRAME_RECORDER_RECORD ? "Recording to" : "Replaying from", file_path);
+    return recorder;
+}
+
+void FrameRecorder_PushEvent(FrameRecorder* recorder, const SDL_Event* event) {
+    if (!recorder || !event || recorder->mode != FRAME_RECORDER_RECORD) return;
+    if (!is_replayable_event(event)) return;
+    if (recorder->event_count >= FRAME_RECORDER_MAX_EVENTS) return;
+    if (!reserve_events(recorder, recorder->event_count + 1)) return;
+
+    recorder->events[recorder->event_count++] = *event;
+}
+
+void FrameRecorder_PushCommand(FrameRecorder* recorder, const void* data, int length) {
+    if (!recorder || !data || length <= 0 || recorder->mode != FRAME_RECORDER_RECORD) return;
+    if ((Uint32)(recorder->command_bytes + length) > FRAME_RECORDER_MAX_COMMAND_BYTES) {
+        fprintf(stderr, "FrameRecorder: Too many command bytes in frame %u, replay will diverge\n", recorder->frame_count);
+        return;
+    }
+    if (!reserve_commands(recorder, recorder->command_bytes + length)) return;
+
+    memcpy(recorder->commands + recorder->command_bytes, data, length);
+    recorder->command_bytes += length;
+}
+
+bool FrameRecorder_WriteFrame(FrameRecorder* recorder, float dt) {
+    if (!recorder || recorder->mode != FRAME_RECORDER_RECORD) return false;
+
+    Uint16 count = (Uint16)recorder->event_count;
+    Uint32 command_bytes = (Uint32)recorder->command_bytes;
+    bool ok = fwrite(&dt, sizeof(dt), 1, recorder->file) == 1 &&
+              fwrite(&count, sizeof(count), 1, recorder->file) == 1 &&
+              (count == 0 || fwrite(recorder->events, sizeof(SDL_Event), count, recorder->file) == count) &&
+              fwrite(&command_bytes, sizeof(command_bytes), 1, recorder->file) == 1 &&
+              (command_bytes == 0 || fwrite(recorder->commands, 1, command_bytes, recorder->file) == command_bytes);
+    recorder->event_count = 0;
+    recorder->command_bytes = 0;
+
+    if (!ok) {
+        fprintf(stderr, "FrameRecorder: Failed to write frame %u\n", recorder->frame_count);
+        return false;
+    }
+    recorder->frame_count++;
+    return true;
+}
+
+bool FrameRecorder_ReadFrame(FrameRecorder* recorder, float* dt, const SDL_Event** events, int* event_count) {
+    if (!recorder || !dt || !events || !event_count || recorder->mode != FRAME_RECORDER_REPLAY) return false;
+
+    Uint16 count = 0;
+    Uint32 command_bytes = 0;
+    if (fread(dt, sizeof(*dt), 1, recorder->file) != 1) return false; // 正常结束
+    if (fread(&count, sizeof(count), 1, recorder->file) != 1 ||
+        !reserve_events(recorder, count) ||
+        (count > 0 && fread(recorder->events, sizeof(SDL_Event), count, recorder->file) != count) ||
+        fread(&command_bytes, sizeof(command_bytes), 1, recorder->file) != 1 ||
+        command_bytes > FRAME_RECORDER_MAX_COMMAND_BYTES ||
+        !reserve_commands(recorder, (int)command_bytes) ||
+        (command_bytes > 0 && fread(recorder->commands, 1, command_bytes, recorder->file) != command_bytes)) {
+        fprintf(stderr, "FrameRecorder: Truncated log at frame %u\n", recorder->frame_count);
+        return false;
+    }
+
+    recorder->event_count = count;
+    recorder->command_bytes = (int)command_bytes;
+    recorder->frame_count++;
+    *events = recorder->events;
+    *event_count = count;
+    return true;
+}
+
+const Uint8* FrameRecorder_GetCommands(const FrameRecorder* recorder, int* length) {
+    if (length) *length = 0;
+    if (!recorder || recorder->mode != FRAME_RECORDER_REPLAY) return NULL;
+    if (length) *length = recorder->command_bytes;
+    return recorder->commands;
+}
+
+void FrameRecorder_ReportFrame(FrameRecorder* recorder, float dt, double frame_ms) {
+    if (!recorder) return;
+
+    if (recorder->frame_count <= 1 || frame_ms < recorder->min_ms) recorder->min_ms = frame_ms;
+    if (recorder->frame_count <= 1 || frame_ms > recorder->max_ms) recorder->max_ms = frame_ms;
+    recorder->total_ms += frame_ms;
+
+    // 每帧一行，便于直接导入表格或脚本对比
+    printf("frame %u dt_ms %.3f cpu_ms %.3f events %d\n",
+           recorder->frame_count, dt * 1000.0f, frame_ms, recorder->event_count);
+}
+
+void FrameRecorder_Close(FrameRecorder* recorder) {
+    if (!recorder) return;
+
+    // 录制模式下补写最后一帧未提交的事件（如退出事件）和命令
+    if (recorder->mode == FRAME_RECORDER_RECORD && (recorder->event_count > 0 || recorder->command_bytes > 0)) {
+        FrameRecorder_WriteFrame(recorder, 0.0f);
+    }
+
+    if (recorder->mode == FRAME_RECORDER_REPLAY && recorder->frame_count > 0) {
+        printf("FrameRecorder: %u frames, cpu_ms min %.3f avg %.3f max %.3f\n",
+               recorder->frame_count, recorder->min_ms,
+               recorder->total_ms / recorder->frame_count, recorder->max_ms);
+    } else {
+        printf("FrameRecorder: Closed (%u frames)\n", recorder->frame_count);
+    }
+
+    fclose(recorder->file);
+    free(recorder->events);
+    free(recorder->commands);
+    free(recorder);
+}
@@ -20,8 +20,8 @@ static ImageCacheNode* find_cache_node(ImageManager* manager, const char* key) {
 }
 
 // 创建新缓存节点
-static ImageCacheNode* create_cache_node(const char* key, SDL_Texture* texture) {
-    if (!key || !texture) return NULL;
+static ImageCacheNode* create_cache_node(const char* key, const char* file_path, SDL_Texture* texture) {
+    if (!key || !file_path) return NULL;
     ImageCacheNode* node = (ImageCacheNode*)malloc(sizeof(ImageCacheNode));
     if (!node) {
         fprintf(stderr, "ImageManager: Failed to allocate cache node\n");
@@ -29,7 +29,10 @@ static ImageCacheNode* create_cache_node(const char* key, SDL_Texture* texture)
     }
     node->key = (char*)malloc(strlen(key) + 1);
     strcpy(node->key, key);
+    node->file_path = (char*)malloc(strlen(file_path) + 1);
+    strcpy(node->file_path, file_path);
     node->texture = texture;
+    node->indexed = NULL;
     node->ref_count = 1;
     node->next = NULL;
     return node;
@@ -39,7 +42,9 @@ static ImageCacheNode* create_cache_node(const char* key, SDL_Texture* texture)
 static void free_cache_node(ImageCacheNode* node) {
     if (!node) return;
     if (node->key) free(node->key);
+    if (node->file_path) free(node->file_path);
     if (node->texture) SDL_DestroyTexture(node->texture);
+    if (node->indexed) SDL_FreeSurface(node->indexed);
     free(node);
 }
 
@@ -64,10 +69,15 @@ ImageManager* ImageManager_GetInstance(SDL_Renderer* renderer) {
 }
 
 SDL_Texture* ImageManager_LoadTexture(ImageManager* manager, const char* key, const char* file_path) {
-    if (!manager || !key || !file_path || !manager->renderer) {
+    if (!manager || !key || !file_path) {
         fprintf(stderr, "ImageManager: Invalid params for LoadTexture\n");
         return NULL;
     }
+    if (!manager->renderer) {
+        // 渲染线程模式下主线程没有渲染器，精灵图须用 RegisterSheet 交给渲染线程上传
+        fprintf(stderr, "ImageManager: No renderer for LoadTexture '%s' (use RegisterSheet with the render thread)\n", key);
+        return NULL;
+    }
 
     // 1. 检查缓存：已加载则返回并增加引用计数
     ImageCacheNode* node = find_cache_node(manager, key);
@@ -85,7 +95,7 @@ SDL_Texture* ImageManager_LoadTexture(ImageManager* manager, const char* key, co
     }
 
     // 3. 创建缓存节点并加入链表
-    node = create_cache_node(key, texture);
+    node = create_cache_node(key, file_path, texture);
     if (!node) {
         SDL_DestroyTexture(texture);
         return NULL;
@@ -98,12 +108,103 @@ SDL_Texture* ImageManager_LoadTexture(ImageManager* manager, const char* key, co
     return texture;
 }
 
+bool ImageManager_RegisterSheet(ImageManager* manager, const char* key, const char* file_path) {
+    if (!manager || !key || !file_path) {
+        fprintf(stderr, "ImageManager: Invalid params for RegisterSheet\n");
+        return false;
+    }
+
+    ImageCacheNode* node = find_cache_node(manager, key);
+    if (node) {
+        node->ref_count++;
+        printf("ImageManager: Sheet '%s' hit cache (ref: %d)\n", key, node->ref_count);
+        return true;
+    }
+
+    // 只登记路径，像素由使用方通过 ImageManager_LoadSurface 解码
+    node = create_cache_node(key, file_path, NULL);
+    if (!node) return false;
+
+    node->next = manager->cache_head;
+    manager->cache_head = node;
+    printf("ImageManager: Sheet '%s' registered (deferred upload)\n", key);
+    return true;
+}
+
+SDL_Surface* ImageManager_LoadIndexed(ImageManager* manager, const char* key, const char* file_path) {
+    if (!manager || !key || !file_path) {
+        fprintf(stderr, "ImageManager: Invalid params for LoadIndexed\n");
+        return NULL;
+    }
+
+    ImageCacheNode* node = find_cache_node(manager, key);
+    if (node) {
+        if (!node->indexed) {
+            fprintf(stderr, "ImageManager: '%s' is already cached as a non-indexed image\n", key);
+            return NULL;
+        }
+        node->ref_count++;
+        printf("ImageManager: Indexed sheet '%s' hit cache (ref: %d)\n", key, node->ref_count);
+        return node->indexed;
+    }
+
+    SDL_Surface* surface = IMG_Load(file_path);
+    if (!surface) {
+        fprintf(stderr, "ImageManager: Failed to load '%s': %s\n", file_path, IMG_GetError());
+        return NULL;
+    }
+    if (surface->format->format != SDL_PIXELFORMAT_INDEX8 || !surface->format->palette) {
+        fprintf(stderr, "ImageManager: '%s' is not an 8-bit indexed image\n", file_path);
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+
+    node = create_cache_node(key, file_path, NULL);
+    if (!node) {
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+    node->indexed = surface;
+
+    node->next = manager->cache_head;
+    manager->cache_head = node;
+    printf("ImageManager: Indexed sheet '%s' loaded (%dx%d, %d colors)\n", key, surface->w, surface->h, surface->format->palette->ncolors);
+    return surface;
+}
+
 SDL_Texture* ImageManager_GetTexture(ImageManager* manager, const char* key) {
     if (!manager || !key) return NULL;
     ImageCacheNode* node = find_cache_node(manager, key);
     return node ? node->texture : NULL;
 }
 
+SDL_Surface* ImageManager_GetIndexed(ImageManager* manager, const char* key) {
+    if (!manager || !key) return NULL;
+    ImageCacheNode* node = find_cache_node(manager, key);
+    return node ? node->indexed : NULL;
+}
+
+const char* ImageManager_GetPath(ImageManager* manager, const char* key) {
+    if (!manager || !key) return NULL;
+    ImageCacheNode* node = find_cache_node(manager, key);
+    return node ? node->file_path : NULL;
+}
+
+SDL_Surface* ImageManager_LoadSurface(ImageManager* manager, const char* key) {
+    if (!manager || !key) return NULL;
+    ImageCacheNode* node = find_cache_node(manager, key);
+    if (!node) {
+        fprintf(stderr, "ImageManager: Texture '%s' not found in cache (load surface failed)\n", key);
+        return NULL;
+    }
+
+    SDL_Surface* surface = IMG_Load(node->file_path);
+    if (!surface) {
+        fprintf(stderr, "ImageManager: Failed to decode '%s': %s\n", node->file_path, IMG_GetError());
+    }
+    return surface;
+}
+
 void ImageManager_ReleaseTexture(ImageManager* manager, const char* key) {
     if (!manager || !key) return;
 
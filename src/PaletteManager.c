@@ -0,0 +1,298 @@
+#include "PaletteManager.h"
+
+// ========== 内部辅助函数 ==========
+static Uint32 hash_entry(const Animation* anim, int tile, const SpritePalette* palette) {
+    uintptr_t h = ((uintptr_t)anim >> 4) ^ ((uintptr_t)palette >> 4) * 31u ^ (uintptr_t)tile * 2654435761u;
+    return (Uint32)(h ^ (h >> 16)) % PALETTE_CACHE_BUCKETS;
+}
+
+static void free_entry(PaletteManager* manager, PaletteCacheEntry* entry) {
+    if (entry->texture) SDL_DestroyTexture(entry->texture);
+    free(entry);
+    manager->entry_count--;
+}
+
+// 用调色板把分块的 8 位索引展开为 RGBA 纹理
+static SDL_Texture* expand_tile(PaletteManager* manager, const Animation* anim, int tile, const SpritePalette* palette) {
+    const SDL_Surface* sheet = anim->index_sheet;
+    const SDL_Rect* area = &anim->tiles[tile].area;
+
+    SDL_Surface* rgba = SDL_CreateRGBSurfaceWithFormat(0, area->w, area->h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!rgba) return NULL;
+
+    // RGBA32 按字节顺序为 R,G,B,A
+    Uint8 lut[256][4];
+    for (int i = 0; i < 256; i++) {
+        lut[i][0] = palette->colors[i].r;
+        lut[i][1] = palette->colors[i].g;
+        lut[i][2] = palette->colors[i].b;
+        lut[i][3] = palette->colors[i].a;
+    }
+    if (anim->transparent_index >= 0) memset(lut[anim->transparent_index], 0, 4);
+
+    for (int y = 0; y < area->h; y++) {
+        const Uint8* src_row = (const Uint8*)sheet->pixels + (size_t)(area->y + y) * sheet->pitch + area->x;
+        Uint8* dst_row = (Uint8*)rgba->pixels + (size_t)y * rgba->pitch;
+        for (int x = 0; x < area->w; x++) {
+            memcpy(dst_row + x * 4, lut[src_row[x]], 4);
+        }
+    }
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(manager->renderer, rgba);
+    SDL_FreeSurface(rgba);
+    if (texture) SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+// 查找展开纹理，没有则创建
+static SDL_Texture* get_expansion(PaletteManager* manager, const Animation* anim, int tile, const SpritePalette* palette) {
+    Uint32 bucket = hash_entry(anim, tile, palette);
+    for (PaletteCacheEntry* entry = manager->buckets[bucket]; entry; entry = entry->next) {
+        if (entry->anim == anim && entry->tile == tile && entry->palette == palette) {
+            entry->last_used = manager->frame;
+            return entry->texture;
+        }
+    }
+
+    SDL_Texture* texture = expand_tile(manager, anim, tile, palette);
+    if (!texture) {
+        fprintf(stderr, "PaletteManager: Failed to expand tile %d of '%s' with '%s': %s\n", tile, anim->texture_key, palette->name, SDL_GetError());
+        return NULL;
+    }
+
+    PaletteCacheEntry* entry = (PaletteCacheEntry*)malloc(sizeof(PaletteCacheEntry));
+    if (!entry) {
+        SDL_DestroyTexture(texture);
+        return NULL;
+    }
+    entry->anim = anim;
+    entry->tile = tile;
+    entry->palette = palette;
+    entry->texture = texture;
+    entry->last_used = manager->frame;
+    entry->next = manager->buckets[bucket];
+    manager->buckets[bucket] = entry;
+    manager->entry_count++;
+    return texture;
+}
+
+// 按目标格式生成查表（软件路径，目标须为每通道 8 位的 32 位格式）
+static const Uint32* palette_lut(SpritePalette* palette, const SDL_PixelFormat* format) {
+    if (palette->lut_format != format->format) {
+        for (int i = 0; i < 256; i++) {
+            const SDL_Color* c = &palette->colors[i];
+            palette->lut[i] = SDL_MapRGBA(format, c->r, c->g, c->b, c->a);
+        }
+        palette->lut_format = format->format;
+    }
+    return palette->lut;
+}
+
+// 查表绘制：8 位索引 -> 目标表面（最近邻缩放，支持翻转；半透明颜色逐字节混合）
+static void lut_blit(
+    const SDL_Surface* sheet, const SDL_Rect* src, int transparent_index,
+    SpritePalette* palette, SDL_Surface* target, const SDL_Rect* dst, SDL_RendererFlip flip
+) {
+    SDL_Rect visible;
+    if (dst->w <= 0 || dst->h <= 0 || !SDL_IntersectRect(dst, &target->clip_rect, &visible)) return;
+
+    const Uint32* lut = palette_lut(palette, target->format);
+    // 16.16 定点步长
+    Uint32 step_x = (Uint32)(((Uint64)src->w << 16) / dst->w);
+    Uint32 step_y = (Uint32)(((Uint64)src->h << 16) / dst->h);
+
+    if (SDL_MUSTLOCK(target)) SDL_LockSurface(target);
+    for (int y = visible.y; y < visible.y + visible.h; y++) {
+        int sy = (int)(((Uint64)(y - dst->y) * step_y) >> 16);
+        if (flip & SDL_FLIP_VERTICAL) sy = src->h - 1 - sy;
+        const Uint8* src_row = (const Uint8*)sheet->pixels + (size_t)(src->y + sy) * sheet->pitch + src->x;
+        Uint32* dst_row = (Uint32*)((Uint8*)target->pixels + (size_t)y * target->pitch);
+
+        for (int x = visible.x; x < visible.x + visible.w; x++) {
+            int sx = (int)(((Uint64)(x - dst->x) * step_x) >> 16);
+            if (flip & SDL_FLIP_HORIZONTAL) sx = src->w - 1 - sx;
+            Uint8 index = src_row[sx];
+            Uint8 alpha = palette->colors[index].a;
+            if (index == transparent_index || alpha == 0) continue;
+            if (alpha == 255) {
+                dst_row[x] = lut[index];
+                continue;
+            }
+            // 每通道 8 位，逐字节混合与通道顺序无关
+            Uint8* d = (Uint8*)&dst_row[x];
+            const Uint8* s = (const Uint8*)&lut[index];
+            for (int k = 0; k < 4; k++) {
+                d[k] = (Uint8)((s[k] * alpha + d[k] * (255 - alpha) + 127) / 255);
+            }
+        }
+    }
+    if (SDL_MUSTLOCK(target)) SDL_UnlockSurface(target);
+}
+
+// ========== 核心接口实现 ==========
+PaletteManager* PaletteManager_Create(SDL_Renderer* renderer) {
+    PaletteManager* manager = (PaletteManager*)calloc(1, sizeof(PaletteManager));
+    if (!manager) {
+        fprintf(stderr, "PaletteManager: Failed to allocate manager\n");
+        return NULL;
+    }
+    manager->renderer = renderer;
+
+    // renderer 为 NULL 时（渲染线程模式）由 RenderQueue_Attach 设置
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0) {
+        manager->software = (info.flags & SDL_RENDERER_SOFTWARE) != 0;
+    }
+    return manager;
+}
+
+SpritePalette* PaletteManager_AddPalette(PaletteManager* manager, const char* name, const SDL_Color* colors, int color_count) {
+    if (!manager || !name || !colors || color_count <= 0 || color_count > 256) {
+        fprintf(stderr, "PaletteManager: Invalid params for AddPalette\n");
+        return NULL;
+    }
+
+    SpritePalette* existing = PaletteManager_GetPalette(manager, name);
+    if (existing) {
+        fprintf(stderr, "PaletteManager: Palette '%s' already exists\n", name);
+        return existing;
+    }
+
+    SpritePalette* palette = (SpritePalette*)calloc(1, sizeof(SpritePalette));
+    SpritePalette** palettes = (SpritePalette**)realloc(manager->palettes, sizeof(SpritePalette*) * (manager->palette_count + 1));
+    if (!palette || !palettes) {
+        fprintf(stderr, "PaletteManager: Failed to allocate palette\n");
+        free(palette);
+        if (palettes) manager->palettes = palettes;
+        return NULL;
+    }
+    manager->palettes = palettes;
+
+    palette->name = (char*)malloc(strlen(name) + 1);
+    strcpy(palette->name, name);
+    memcpy(palette->colors, colors, sizeof(SDL_Color) * color_count);
+    palette->color_count = color_count;
+    manager->palettes[manager->palette_count++] = palette;
+
+    printf("PaletteManager: Palette '%s' added (%d colors)\n", name, color_count);
+    return palette;
+}
+
+SpritePalette* PaletteManager_GetPalette(PaletteManager* manager, const char* name) {
+    if (!manager || !name) return NULL;
+    for (int i = 0; i < manager->palette_count; i++) {
+        if (strcmp(manager->palettes[i]->name, name) == 0) {
+            return manager->palettes[i];
+        }
+    }
+    return NULL;
+}
+
+void PaletteManager_SetTarget(PaletteManager* manager, SDL_Surface* target) {
+    if (!manager) return;
+    // 查表写入要求每通道 8 位的 32 位目标
+    if (target && target->format->BytesPerPixel != 4) {
+        fprintf(stderr, "PaletteManager: Target surface must be 32-bit, LUT blit disabled\n");
+        target = NULL;
+    }
+    manager->target = target;
+}
+
+void PaletteManager_Draw(
+    PaletteManager* manager,
+    const Animation* anim,
+    int tile,
+    const SpritePalette* palette,
+    const SDL_Rect* src,
+    const SDL_Rect* dst,
+    double angle,
+    SDL_RendererFlip flip
+) {
+    if (!manager || !anim || !anim->index_sheet || !src || !dst) return;
+    if (tile < 0 || tile >= anim->tile_count) return;
+    if (!palette) palette = anim->default_palette;
+    if (!palette) return;
+
+    if (manager->software && manager->target && angle == 0.0) {
+        // 先提交渲染器中已排队的命令，保证绘制顺序
+        SDL_RenderFlush(manager->renderer);
+        const SDL_Rect* area = &anim->tiles[tile].area;
+        SDL_Rect sheet_src = { area->x + src->x, area->y + src->y, src->w, src->h };
+        lut_blit(anim->index_sheet, &sheet_src, anim->transparent_index, (SpritePalette*)palette, manager->target, dst, flip);
+        return;
+    }
+
+    SDL_Texture* texture = get_expansion(manager, anim, tile, palette);
+    if (!texture) return;
+    SDL_RenderCopyEx(manager->renderer, texture, src, dst, angle, NULL, flip);
+}
+
+void PaletteManager_EndFrame(PaletteManager* manager) {
+    if (!manager) return;
+
+    manager->frame++;
+    if (manager->frame % PALETTE_CACHE_SWEEP_INTERVAL != 0 || manager->entry_count == 0) return;
+
+    int evicted = 0;
+    for (int b = 0; b < PALETTE_CACHE_BUCKETS; b++) {
+        PaletteCacheEntry** link = &manager->buckets[b];
+        while (*link) {
+            PaletteCacheEntry* entry = *link;
+            if (manager->frame - entry->last_used > PALETTE_CACHE_EVICT_FRAMES) {
+                *link = entry->next;
+                free_entry(manager, entry);
+                evicted++;
+            } else {
+                link = &entry->next;
+            }
+        }
+    }
+    if (evicted) {
+        printf("PaletteManager: Evicted %d unused expansions (%d cached)\n", evicted, manager->entry_count);
+    }
+}
+
+void PaletteManager_ForgetAnimation(PaletteManager* manager, const Animation* anim) {
+    if (!manager || !anim) return;
+
+    for (int b = 0; b < PALETTE_CACHE_BUCKETS; b++) {
+        PaletteCacheEntry** link = &manager->buckets[b];
+        while (*link) {
+            PaletteCacheEntry* entry = *link;
+            if (entry->anim == anim) {
+                *link = entry->next;
+                free_entry(manager, entry);
+            } else {
+                link = &entry->next;
+            }
+        }
+    }
+}
+
+void PaletteManager_ReleaseTextures(PaletteManager* manager) {
+    if (!manager) return;
+
+    for (int b = 0; b < PALETTE_CACHE_BUCKETS; b++) {
+        PaletteCacheEntry* entry = manager->buckets[b];
+        while (entry) {
+            PaletteCacheEntry* next = entry->next;
+            free_entry(manager, entry);
+            entry = next;
+        }
+        manager->buckets[b] = NULL;
+    }
+}
+
+void PaletteManager_Destroy(PaletteManager* manager) {
+    if (!manager) return;
+
+    PaletteManager_ReleaseTextures(manager);
+    for (int i = 0; i < manager->palette_count; i++) {
+        free(manager->palettes[i]->name);
+        free(manager->palettes[i]);
+    }
+    free(manager->palettes);
+    free(manager);
+
+    printf("PaletteManager: Destroyed\n");
+}
@@ -0,0 +1,318 @@
+#include "ParticleEmitter.h"
+#include "RenderQueue.h"
+#include <math.h>
+
+// ========== 内部辅助函数 ==========
+// 查找动画序列
+static AnimationClip* find_clip(Animation* anim, const char* clip_name) {
+    for (int i = 0; i < anim->clip_count; i++) {
+        if (strcmp(anim->clips[i]->name, clip_name) == 0) {
+            return anim->clips[i];
+        }
+    }
+    return NULL;
+}
+
+// 序列位置 -> 帧索引（反向序列从末尾播放）
+static int clip_frame(const AnimationClip* clip, int pos) {
+    return clip->frame_indices[clip->reverse ? clip->frame_count - 1 - pos : pos];
+}
+
+// xorshift32，返回 [0, 1)
+static float next_random(ParticleEmitter* emitter) {
+    Uint32 s = emitter->rng;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    emitter->rng = s;
+    return (s >> 8) * (1.0f / 16777216.0f);
+}
+
+// ========== 核心接口实现 ==========
+ParticleEmitter* ParticleEmitter_Create(AnimationManager* anim_manager, Animation* anim, const char* clip_name, int capacity) {
+    if (!anim_manager || !anim || !anim->frames || !clip_name || capacity <= 0 || capacity > PARTICLE_EMITTER_MAX_CAPACITY) {
+        fprintf(stderr, "ParticleEmitter: Invalid params for Create\n");
+        return NULL;
+    }
+    if (anim->index_sheet) {
+        fprintf(stderr, "ParticleEmitter: Indexed animation '%s' is not supported\n", anim->texture_key);
+        return NULL;
+    }
+
+    const AnimationClip* clip = find_clip(anim, clip_name);
+    if (!clip) {
+        fprintf(stderr, "ParticleEmitter: Clip '%s' not found in animation '%s'\n", clip_name, anim->texture_key);
+        return NULL;
+    }
+    // 一次批量绘制只能用一张纹理
+    int tile = anim->frames[clip->frame_indices[0]].tile;
+    for (int i = 1; i < clip->frame_count; i++) {
+        if (anim->frames[clip->frame_indices[i]].tile != tile) {
+            fprintf(stderr, "ParticleEmitter: Clip '%s' spans several tiles\n", clip_name);
+            return NULL;
+        }
+    }
+    AnimationManager_PrepareClip(anim_manager, anim, clip);
+
+    ParticleEmitter* emitter = (ParticleEmitter*)calloc(1, sizeof(ParticleEmitter));
+    if (!emitter) {
+        fprintf(stderr, "ParticleEmitter: Failed to allocate emitter\n");
+        return NULL;
+    }
+
+    emitter->capacity = capacity;
+    emitter->anim = anim;
+    emitter->clip = clip;
+    emitter->tile = tile;
+    emitter->anim_manager = anim_manager;
+    emitter->renderer = anim_manager->renderer;
+    emitter->stats = anim_manager->stats;
+
+    size_t n = (size_t)capacity;
+    emitter->x = (float*)malloc(sizeof(float) * n);
+    emitter->y = (float*)malloc(sizeof(float) * n);
+    emitter->vx = (float*)malloc(sizeof(float) * n);
+    emitter->vy = (float*)malloc(sizeof(float) * n);
+    emitter->age = (float*)malloc(sizeof(float) * n);
+    emitter->life = (float*)malloc(sizeof(float) * n);
+    emitter->frame = (int*)malloc(sizeof(int) * n);
+    emitter->frame_uv = (float*)malloc(sizeof(float) * 4 * clip->frame_count);
+    emitter->vertices = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * n);
+    emitter->indices = (int*)malloc(sizeof(int) * 6 * n);
+
+    if (!emitter->x || !emitter->y || !emitter->vx || !emitter->vy || !emitter->age || !emitter->life ||
+        !emitter->frame || !emitter->frame_uv || !emitter->vertices || !emitter->indices) {
+        fprintf(stderr, "ParticleEmitter: Failed to allocate particle arrays\n");
+        ParticleEmitter_Destroy(emitter);
+        return NULL;
+    }
+
+    // 序列帧在分块纹理中的坐标（按播放顺序）
+    const SDL_Rect* area = &anim->tiles[tile].area;
+    for (int i = 0; i < clip->frame_count; i++) {
+        const SDL_Rect* src = &anim->frames[clip_frame(clip, i)].src;
+        emitter->frame_uv[i * 4 + 0] = (float)src->x / area->w;
+        emitter->frame_uv[i * 4 + 1] = (float)src->y / area->h;
+        emitter->frame_uv[i * 4 + 2] = (float)(src->x + src->w) / area->w;
+        emitter->frame_uv[i * 4 + 3] = (float)(src->y + src->h) / area->h;
+    }
+
+    // 每个粒子两个三角形，索引固定
+    for (int p = 0; p < capacity; p++) {
+        int v = p * 4;
+        int* idx = &emitter->indices[p * 6];
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+    }
+
+    // 默认参数：向四周发射，0.5~1 秒寿命
+    emitter->spread = 2.0f * (float)M_PI;
+    emitter->speed_min = 50.0f;
+    emitter->speed_max = 150.0f;
+    emitter->life_min = 0.5f;
+    emitter->life_max = 1.0f;
+    emitter->rng = 0x9E3779B9u ^ (Uint32)capacity;
+    ParticleEmitter_SetAppearance(emitter, 1.0f, true);
+
+    printf("ParticleEmitter: Created (capacity: %d, clip: '%s')\n", capacity, clip_name);
+    return emitter;
+}
+
+void ParticleEmitter_SetOrigin(ParticleEmitter* emitter, float x, float y) {
+    if (!emitter) return;
+    emitter->origin_x = x;
+    emitter->origin_y = y;
+}
+
+void ParticleEmitter_SetEmission(ParticleEmitter* emitter, float angle, float spread, float speed_min, float speed_max, float life_min, float life_max) {
+    if (!emitter || speed_max < speed_min || life_min <= 0 || life_max < life_min) return;
+    emitter->angle = angle;
+    emitter->spread = spread;
+    emitter->speed_min = speed_min;
+    emitter->speed_max = speed_max;
+    emitter->life_min = life_min;
+    emitter->life_max = life_max;
+}
+
+void ParticleEmitter_SetGravity(ParticleEmitter* emitter, float gravity_x, float gravity_y) {
+    if (!emitter) return;
+    emitter->gravity_x = gravity_x;
+    emitter->gravity_y = gravity_y;
+}
+
+void ParticleEmitter_SetRate(ParticleEmitter* emitter, float rate) {
+    if (!emitter || rate < 0) return;
+    emitter->rate = rate;
+}
+
+void ParticleEmitter_SetAppearance(ParticleEmitter* emitter, float scale, bool fade) {
+    if (!emitter || scale <= 0) return;
+    const SDL_Rect* src = &emitter->anim->frames[emitter->clip->frame_indices[0]].src;
+    emitter->frame_w = src->w * scale;
+    emitter->frame_h = src->h * scale;
+    emitter->fade = fade;
+}
+
+int ParticleEmitter_Emit(ParticleEmitter* emitter, int n) {
+    if (!emitter || n <= 0) return 0;
+    if (n > emitter->capacity - emitter->count) n = emitter->capacity - emitter->count;
+
+    for (int k = 0; k < n; k++) {
+        int d = emitter->count++;
+        float angle = emitter->angle + (next_random(emitter) - 0.5f) * emitter->spread;
+        float speed = emitter->speed_min + (emitter->speed_max - emitter->speed_min) * next_random(emitter);
+        emitter->x[d] = emitter->origin_x;
+        emitter->y[d] = emitter->origin_y;
+        emitter->vx[d] = cosf(angle) * speed;
+        emitter->vy[d] = sinf(angle) * speed;
+        emitter->age[d] = 0.0f;
+        emitter->life[d] = emitter->life_min + (emitter->life_max - emitter->life_min) * next_random(emitter);
+        emitter->frame[d] = 0;
+    }
+    return n;
+}
+
+void ParticleEmitter_Update(ParticleEmitter* emitter, float dt) {
+    if (!emitter || dt <= 0) return;
+
+    // 连续发射（小数部分累积到下一帧）
+    if (emitter->rate > 0) {
+        emitter->rate_accum += emitter->rate * dt;
+        int spawn = (int)emitter->rate_accum;
+        emitter->rate_accum -= spawn;
+        ParticleEmitter_Emit(emitter, spawn);
+    }
+
+    int n = emitter->count;
+    float* restrict x = emitter->x;
+    float* restrict y = emitter->y;
+    float* restrict vx = emitter->vx;
+    float* restrict vy = emitter->vy;
+    float* restrict age = emitter->age;
+    float* restrict life = emitter->life;
+    int* restrict frame = emitter->frame;
+    const float gx = emitter->gravity_x * dt;
+    const float gy = emitter->gravity_y * dt;
+
+    // 年龄与运动积分：无分支的独立循环，便于编译器向量化
+    for (int i = 0; i < n; i++) {
+        age[i] += dt;
+    }
+    for (int i = 0; i < n; i++) {
+        vx[i] += gx;
+        vy[i] += gy;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+
+    // 回收死亡粒子（swap-remove，末尾粒子填入空位后原地重新检查）
+    for (int i = 0; i < n;) {
+        if (age[i] < life[i]) {
+            i++;
+            continue;
+        }
+        n--;
+        x[i] = x[n];
+        y[i] = y[n];
+        vx[i] = vx[n];
+        vy[i] = vy[n];
+        age[i] = age[n];
+        life[i] = life[n];
+    }
+    emitter->count = n;
+
+    // 按年龄计算序列位置（循环序列取模，否则停在最后一帧）
+    const AnimationClip* clip = emitter->clip;
+    const float inv_duration = 1.0f / clip->frame_duration;
+    const float frame_count = (float)clip->frame_count;
+    const float last = frame_count - 1.0f;
+    if (clip->loop) {
+        const float inv_count = 1.0f / frame_count;
+        for (int i = 0; i < n; i++) {
+            float t = age[i] * inv_duration;
+            float pos = t - (float)(int)(t * inv_count) * frame_count; // t >= 0，截断即向下取整
+            frame[i] = (int)(pos < last ? pos : last);
+        }
+    } else {
+        for (int i = 0; i < n; i++) {
+            float pos = age[i] * inv_duration;
+            frame[i] = (int)(pos < last ? pos : last);
+        }
+    }
+}
+
+void ParticleEmitter_Draw(ParticleEmitter* emitter) {
+    if (!emitter || emitter->count == 0) return;
+
+    int n = emitter->count;
+    const float hw = emitter->frame_w * 0.5f;
+    const float hh = emitter->frame_h * 0.5f;
+    Uint64 pixels = (Uint64)((double)emitter->frame_w * emitter->frame_h * n);
+
+    // 使用渲染线程时分块纹理归渲染线程所有，这里不读取
+    struct RenderQueue* queue = emitter->anim_manager->queue;
+    SDL_Texture* texture = queue ? NULL : emitter->anim->tiles[emitter->tile].texture;
+    if (!queue && !texture) return;
+
+    // 先取出数组指针，避免写顶点时因别名反复重读 emitter
+    const float* restrict x = emitter->x;
+    const float* restrict y = emitter->y;
+    const float* restrict age = emitter->age;
+    const float* restrict life = emitter->life;
+    const int* restrict frame = emitter->frame;
+    const float* restrict frame_uv = emitter->frame_uv;
+    const float w = emitter->frame_w;
+    const float h = emitter->frame_h;
+    const bool fade = emitter->fade;
+
+    SDL_Vertex* restrict v = emitter->vertices;
+    for (int i = 0; i < n; i++, v += 4) {
+        const float* uv = &frame_uv[frame[i] * 4];
+        float x0 = x[i] - hw;
+        float y0 = y[i] - hh;
+        float x1 = x0 + w;
+        float y1 = y0 + h;
+        Uint8 alpha = fade ? (Uint8)(255.0f - 255.0f * age[i] / life[i]) : 255;
+        SDL_Color color = { 255, 255, 255, alpha };
+
+        v[0] = (SDL_Vertex){ { x0, y0 }, color, { uv[0], uv[1] } };
+        v[1] = (SDL_Vertex){ { x1, y0 }, color, { uv[2], uv[1] } };
+        v[2] = (SDL_Vertex){ { x0, y1 }, color, { uv[0], uv[3] } };
+        v[3] = (SDL_Vertex){ { x1, y1 }, color, { uv[2], uv[3] } };
+    }
+
+    if (queue) {
+        RenderQueue_PushGeometry(queue, emitter->anim, emitter->tile, emitter->vertices, n);
+        RenderStats_RecordBatch(emitter->stats, &emitter->anim->tiles[emitter->tile], n, pixels);
+        return;
+    }
+    if (SDL_RenderGeometry(emitter->renderer, texture, emitter->vertices, n * 4, emitter->indices, n * 6) != 0) {
+        fprintf(stderr, "ParticleEmitter: SDL_RenderGeometry failed: %s\n", SDL_GetError());
+        return;
+    }
+    RenderStats_RecordBatch(emitter->stats, texture, n, pixels);
+}
+
+void ParticleEmitter_Clear(ParticleEmitter* emitter) {
+    if (!emitter) return;
+    emitter->count = 0;
+    emitter->rate_accum = 0.0f;
+}
+
+void ParticleEmitter_Destroy(ParticleEmitter* emitter) {
+    if (!emitter) return;
+
+    free(emitter->x);
+    free(emitter->y);
+    free(emitter->vx);
+    free(emitter->vy);
+    free(emitter->age);
+    free(emitter->life);
+    free(emitter->frame);
+    free(emitter->frame_uv);
+    free(emitter->vertices);
+    free(emitter->indices);
+    free(emitter);
+
+    printf("ParticleEmitter: Destroyed\n");
+}
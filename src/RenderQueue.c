@@ -0,0 +1,343 @@
+#include "RenderQueue.h"
+#include "PaletteManager.h"
+
+// ========== 内部辅助函数 ==========
+// 保证四边形索引至少覆盖 quads 个四边形（渲染线程）
+static bool ensure_quad_indices(RenderQueue* queue, int quads) {
+    if (quads <= queue->quad_capacity) return true;
+
+    int capacity = queue->quad_capacity ? queue->quad_capacity : 1024;
+    while (capacity < quads) capacity *= 2;
+    int* indices = (int*)realloc(queue->quad_indices, sizeof(int) * 6 * capacity);
+    if (!indices) {
+        fprintf(stderr, "RenderQueue: Failed to grow quad indices\n");
+        return false;
+    }
+    for (int q = queue->quad_capacity; q < capacity; q++) {
+        int v = q * 4;
+        int* idx = &indices[q * 6];
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+    }
+    queue->quad_indices = indices;
+    queue->quad_capacity = capacity;
+    return true;
+}
+
+// 追加一条命令（模拟线程）
+static DrawCommand* push_command(RenderQueue* queue) {
+    DrawList* list = &queue->lists[queue->record];
+    if (list->count >= list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        DrawCommand* commands = (DrawCommand*)realloc(list->commands, sizeof(DrawCommand) * capacity);
+        if (!commands) {
+            fprintf(stderr, "RenderQueue: Failed to grow draw list\n");
+            return NULL;
+        }
+        list->commands = commands;
+        list->capacity = capacity;
+    }
+    return &list->commands[list->count++];
+}
+
+// 执行列表中的延迟任务（渲染线程，列表中的命令均已执行）
+static void run_tasks(RenderQueue* queue, const DrawList* list) {
+    for (int i = 0; i < list->task_count; i++) {
+        list->tasks[i].run(queue, list->tasks[i].data);
+    }
+}
+
+// 上传本帧用到但尚未上传的分块（渲染线程）：同一动画缺的分块收集齐后只解码一次源图片
+static void upload_missing_tiles(RenderQueue* queue, const DrawList* list) {
+    for (int i = 0; i < list->count; i++) {
+        Animation* anim = list->commands[i].anim;
+        if (anim->index_sheet || !anim->sheet_path || anim->tiles[list->commands[i].tile].texture) continue;
+
+        if (anim->tile_count > queue->upload_capacity) {
+            int* tiles = (int*)realloc(queue->upload_tiles, sizeof(int) * anim->tile_count);
+            if (!tiles) {
+                fprintf(stderr, "RenderQueue: Failed to grow upload list\n");
+                return;
+            }
+            queue->upload_tiles = tiles;
+            queue->upload_capacity = anim->tile_count;
+        }
+        int count = 0;
+        for (int j = i; j < list->count; j++) {
+            const DrawCommand* cmd = &list->commands[j];
+            if (cmd->anim != anim || anim->tiles[cmd->tile].texture) continue;
+            bool seen = false;
+            for (int k = 0; k < count && !seen; k++) seen = queue->upload_tiles[k] == cmd->tile;
+            if (!seen) queue->upload_tiles[count++] = cmd->tile;
+        }
+        AnimationManager_UploadTiles(queue->anim_manager, anim, queue->upload_tiles, count);
+    }
+}
+
+// 执行一帧命令（渲染线程）
+static void execute_list(RenderQueue* queue, const DrawList* list) {
+    if (SDL_RenderClear(queue->renderer) != 0) {
+        fprintf(stderr, "SDL_RenderClear failed: %s\n", SDL_GetError());
+    }
+    upload_missing_tiles(queue, list);
+
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand* cmd = &list->commands[i];
+        if (cmd->anim->index_sheet) {
+            PaletteManager_Draw(queue->anim_manager->palettes, cmd->anim, cmd->tile, cmd->palette,
+                                &cmd->src, &cmd->dst, cmd->angle, (SDL_RendererFlip)cmd->flip);
+            continue;
+        }
+        AnimationTile* tile = &cmd->anim->tiles[cmd->tile];
+        if (!tile->texture) continue; // 上传失败
+
+        if (cmd->quad_count > 0) {
+            if (!ensure_quad_indices(queue, cmd->quad_count)) continue;
+            SDL_RenderGeometry(queue->renderer, tile->texture, list->vertices + cmd->vertex_offset,
+                               cmd->quad_count * 4, queue->quad_indices, cmd->quad_count * 6);
+            continue;
+        }
+
+        SDL_RenderCopyEx(
+            queue->renderer,
+            tile->texture,
+            &cmd->src,
+            &cmd->dst,
+            cmd->angle,
+            NULL,
+            (SDL_RendererFlip)cmd->flip
+        );
+    }
+
+    SDL_RenderPresent(queue->renderer);
+    if (queue->anim_manager) PaletteManager_EndFrame(queue->anim_manager->palettes);
+    run_tasks(queue, list);
+}
+
+static int render_thread_main(void* data) {
+    RenderQueue* queue = (RenderQueue*)data;
+
+    // 渲染器在本线程创建，之后所有渲染调用都在本线程
+    SDL_Renderer* renderer = SDL_CreateRenderer(queue->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!renderer) renderer = SDL_CreateRenderer(queue->window, -1, SDL_RENDERER_SOFTWARE);
+    SDL_RendererInfo info;
+    if (renderer) {
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        if (SDL_GetRendererInfo(renderer, &info) == 0) {
+            queue->max_texture_w = info.max_texture_width;
+            queue->max_texture_h = info.max_texture_height;
+            queue->software = (info.flags & SDL_RENDERER_SOFTWARE) != 0;
+        }
+    }
+
+    SDL_LockMutex(queue->mutex);
+    queue->thread_id = SDL_ThreadID();
+    queue->renderer = renderer;
+    queue->ready = true;
+    SDL_CondBroadcast(queue->cond);
+    SDL_UnlockMutex(queue->mutex);
+    if (!renderer) return 1;
+
+    for (;;) {
+        SDL_LockMutex(queue->mutex);
+        while (queue->pending < 0 && !queue->quit) {
+            SDL_CondWait(queue->cond, queue->mutex);
+        }
+        if (queue->pending < 0) { // quit 且没有待渲染的帧
+            SDL_UnlockMutex(queue->mutex);
+            break;
+        }
+        queue->rendering = queue->pending;
+        queue->pending = -1;
+        SDL_CondBroadcast(queue->cond);
+        SDL_UnlockMutex(queue->mutex);
+
+        // 执行期间不持锁，模拟线程可同时录制另一块缓冲
+        execute_list(queue, &queue->lists[queue->rendering]);
+
+        SDL_LockMutex(queue->mutex);
+        queue->rendering = -1;
+        SDL_CondBroadcast(queue->cond);
+        SDL_UnlockMutex(queue->mutex);
+    }
+
+    // 模拟线程已停止录制：执行未提交的任务，再在本线程释放纹理
+    SDL_LockMutex(queue->mutex);
+    int record = queue->record;
+    SDL_UnlockMutex(queue->mutex);
+    run_tasks(queue, &queue->lists[record]);
+    queue->lists[record].task_count = 0;
+    if (queue->anim_manager) AnimationManager_ReleaseTextures(queue->anim_manager);
+
+    SDL_DestroyRenderer(renderer);
+    return 0;
+}
+
+// ========== 核心接口实现 ==========
+RenderQueue* RenderQueue_Create(SDL_Window* window) {
+    if (!window) {
+        fprintf(stderr, "RenderQueue: Invalid window\n");
+        return NULL;
+    }
+
+    RenderQueue* queue = (RenderQueue*)calloc(1, sizeof(RenderQueue));
+    if (!queue) {
+        fprintf(stderr, "RenderQueue: Failed to allocate queue\n");
+        return NULL;
+    }
+    queue->window = window;
+    queue->record = 0;
+    queue->pending = -1;
+    queue->rendering = -1;
+    queue->mutex = SDL_CreateMutex();
+    queue->cond = SDL_CreateCond();
+    if (!queue->mutex || !queue->cond) {
+        fprintf(stderr, "RenderQueue: Failed to create sync objects: %s\n", SDL_GetError());
+        RenderQueue_Destroy(queue);
+        return NULL;
+    }
+
+    queue->thread = SDL_CreateThread(render_thread_main, "render", queue);
+    if (!queue->thread) {
+        fprintf(stderr, "RenderQueue: Failed to create render thread: %s\n", SDL_GetError());
+        RenderQueue_Destroy(queue);
+        return NULL;
+    }
+
+    // 等待渲染线程创建渲染器
+    SDL_LockMutex(queue->mutex);
+    while (!queue->ready) {
+        SDL_CondWait(queue->cond, queue->mutex);
+    }
+    SDL_UnlockMutex(queue->mutex);
+
+    if (!queue->renderer) {
+        fprintf(stderr, "SDL Error: %s (in SDL_CreateRenderer, render thread)\n", SDL_GetError());
+        RenderQueue_Destroy(queue);
+        return NULL;
+    }
+
+    printf("RenderQueue: Render thread started\n");
+    return queue;
+}
+
+void RenderQueue_Attach(RenderQueue* queue, AnimationManager* anim_manager) {
+    if (!queue || !anim_manager) return;
+    if (anim_manager->renderer) {
+        fprintf(stderr, "RenderQueue: AnimationManager must be created without a renderer\n");
+        return;
+    }
+    queue->anim_manager = anim_manager;
+    anim_manager->queue = queue;
+    // 展开纹理只在渲染线程创建（execute_list 中调用 PaletteManager_Draw）
+    anim_manager->palettes->renderer = queue->renderer;
+    anim_manager->palettes->software = queue->software;
+}
+
+void RenderQueue_Push(RenderQueue* queue, Animation* anim, int tile, const struct SpritePalette* palette, const SDL_Rect* src, const SDL_Rect* dst, float angle, SDL_RendererFlip flip) {
+    if (!queue || !anim || !src || !dst) return;
+
+    DrawCommand* cmd = push_command(queue);
+    if (!cmd) return;
+    cmd->anim = anim;
+    cmd->tile = tile;
+    cmd->palette = palette;
+    cmd->src = *src;
+    cmd->dst = *dst;
+    cmd->angle = angle;
+    cmd->flip = (Uint8)flip;
+    cmd->vertex_offset = 0;
+    cmd->quad_count = 0;
+}
+
+void RenderQueue_PushGeometry(RenderQueue* queue, Animation* anim, int tile, const SDL_Vertex* vertices, int quad_count) {
+    if (!queue || !anim || !vertices || quad_count <= 0) return;
+
+    DrawList* list = &queue->lists[queue->record];
+    int needed = list->vertex_count + quad_count * 4;
+    if (needed > list->vertex_capacity) {
+        int capacity = list->vertex_capacity ? list->vertex_capacity : 4096;
+        while (capacity < needed) capacity *= 2;
+        SDL_Vertex* grown = (SDL_Vertex*)realloc(list->vertices, sizeof(SDL_Vertex) * capacity);
+        if (!grown) {
+            fprintf(stderr, "RenderQueue: Failed to grow vertex buffer\n");
+            return;
+        }
+        list->vertices = grown;
+        list->vertex_capacity = capacity;
+    }
+
+    DrawCommand* cmd = push_command(queue);
+    if (!cmd) return;
+    memset(cmd, 0, sizeof(DrawCommand));
+    cmd->anim = anim;
+    cmd->tile = tile;
+    cmd->vertex_offset = list->vertex_count;
+    cmd->quad_count = quad_count;
+    memcpy(list->vertices + list->vertex_count, vertices, sizeof(SDL_Vertex) * quad_count * 4);
+    list->vertex_count = needed;
+}
+
+void RenderQueue_Defer(RenderQueue* queue, RenderQueueTask task, void* data) {
+    if (!queue || !task) return;
+
+    DrawList* list = &queue->lists[queue->record];
+    if (list->task_count >= list->task_capacity) {
+        int capacity = list->task_capacity ? list->task_capacity * 2 : 16;
+        RenderTask* tasks = (RenderTask*)realloc(list->tasks, sizeof(RenderTask) * capacity);
+        if (!tasks) {
+            // 丢弃任务会泄漏或悬空，宁可立即失败
+            fprintf(stderr, "RenderQueue: Failed to grow task list\n");
+            abort();
+        }
+        list->tasks = tasks;
+        list->task_capacity = capacity;
+    }
+    list->tasks[list->task_count].run = task;
+    list->tasks[list->task_count].data = data;
+    list->task_count++;
+}
+
+void RenderQueue_Submit(RenderQueue* queue) {
+    if (!queue) return;
+
+    SDL_LockMutex(queue->mutex);
+    int next = 1 - queue->record;
+    // 另一块缓冲仍在等待或正在渲染（上一帧还没画完）时等待
+    while (queue->pending >= 0 || queue->rendering == next) {
+        SDL_CondWait(queue->cond, queue->mutex);
+    }
+    queue->pending = queue->record;
+    queue->record = next;
+    queue->lists[next].count = 0;
+    queue->lists[next].vertex_count = 0;
+    queue->lists[next].task_count = 0;
+    SDL_CondBroadcast(queue->cond);
+    SDL_UnlockMutex(queue->mutex);
+}
+
+void RenderQueue_Destroy(RenderQueue* queue) {
+    if (!queue) return;
+
+    if (queue->thread) {
+        SDL_LockMutex(queue->mutex);
+        queue->quit = true;
+        SDL_CondBroadcast(queue->cond);
+        SDL_UnlockMutex(queue->mutex);
+        SDL_WaitThread(queue->thread, NULL);
+    }
+    if (queue->anim_manager) queue->anim_manager->queue = NULL;
+
+    if (queue->cond) SDL_DestroyCond(queue->cond);
+    if (queue->mutex) SDL_DestroyMutex(queue->mutex);
+    for (int i = 0; i < 2; i++) {
+        free(queue->lists[i].commands);
+        free(queue->lists[i].vertices);
+        free(queue->lists[i].tasks);
+    }
+    free(queue->quad_indices);
+    free(queue->upload_tiles);
+    free(queue);
+
+    printf("RenderQueue: Destroyed\n");
+}
@@ -0,0 +1,112 @@
+#include "RenderStats.h"
+
+// 静态实例（全局唯一，无需分配）
+static RenderStats s_stats;
+
+// ========== 内部辅助函数 ==========
+// 目标矩形裁剪到屏幕后的像素数
+static Uint64 clipped_pixels(const RenderStats* stats, const SDL_Rect* rect) {
+    int x0 = rect->x < 0 ? 0 : rect->x;
+    int y0 = rect->y < 0 ? 0 : rect->y;
+    int x1 = rect->x + rect->w > stats->screen_w ? stats->screen_w : rect->x + rect->w;
+    int y1 = rect->y + rect->h > stats->screen_h ? stats->screen_h : rect->y + rect->h;
+    if (x1 <= x0 || y1 <= y0) return 0;
+    return (Uint64)(x1 - x0) * (Uint64)(y1 - y0);
+}
+
+// ========== 核心接口实现 ==========
+RenderStats* RenderStats_GetInstance(void) {
+    return &s_stats;
+}
+
+void RenderStats_BeginFrame(RenderStats* stats, SDL_Renderer* renderer) {
+    if (!stats) return;
+
+    memset(&stats->current, 0, sizeof(stats->current));
+    stats->current.clears = 1;
+    stats->last_texture = NULL;
+    if (renderer) {
+        SDL_GetRendererOutputSize(renderer, &stats->screen_w, &stats->screen_h);
+    }
+}
+
+void RenderStats_RecordDraw(RenderStats* stats, const void* texture, const SDL_Rect* dst_rect) {
+    if (!stats) return;
+
+    stats->current.draw_calls++;
+    stats->current.sprites++;
+    if (texture != stats->last_texture) {
+        stats->current.texture_switches++;
+        stats->last_texture = texture;
+    }
+    if (dst_rect) {
+        stats->current.pixels_filled += clipped_pixels(stats, dst_rect);
+    }
+}
+
+void RenderStats_RecordBatch(RenderStats* stats, const void* texture, int sprites, Uint64 pixels) {
+    if (!stats) return;
+
+    stats->current.draw_calls++;
+    stats->current.sprites += sprites;
+    if (texture != stats->last_texture) {
+        stats->current.texture_switches++;
+        stats->last_texture = texture;
+    }
+    stats->current.pixels_filled += pixels;
+}
+
+void RenderStats_EndFrame(RenderStats* stats) {
+    if (!stats) return;
+
+    Uint64 screen_pixels = (Uint64)stats->screen_w * (Uint64)stats->screen_h;
+    stats->current.overdraw = screen_pixels ? (float)((double)stats->current.pixels_filled / screen_pixels) : 0.0f;
+
+    stats->last = stats->current;
+    stats->history[stats->history_head] = stats->current;
+    stats->history_head = (stats->history_head + 1) % RENDER_STATS_HISTORY;
+    if (stats->history_count < RENDER_STATS_HISTORY) stats->history_count++;
+}
+
+const RenderFrameStats* RenderStats_GetLastFrame(const RenderStats* stats) {
+    return stats ? &stats->last : NULL;
+}
+
+bool RenderStats_GetSummary(const RenderStats* stats, RenderStatsSummary* summary) {
+    if (!stats || !summary || stats->history_count == 0) return false;
+
+    const RenderFrameStats* first = &stats->history[0];
+    summary->min = *first;
+    summary->max = *first;
+    double clears = 0, draw_calls = 0, switches = 0, sprites = 0, pixels = 0, overdraw = 0;
+
+    for (int i = 0; i < stats->history_count; i++) {
+        const RenderFrameStats* f = &stats->history[i];
+        #define RS_MINMAX(field) \
+            if (f->field < summary->min.field) summary->min.field = f->field; \
+            if (f->field > summary->max.field) summary->max.field = f->field;
+        RS_MINMAX(clears)
+        RS_MINMAX(draw_calls)
+        RS_MINMAX(texture_switches)
+        RS_MINMAX(sprites)
+        RS_MINMAX(pixels_filled)
+        RS_MINMAX(overdraw)
+        #undef RS_MINMAX
+        clears += f->clears;
+        draw_calls += f->draw_calls;
+        switches += f->texture_switches;
+        sprites += f->sprites;
+        pixels += (double)f->pixels_filled;
+        overdraw += f->overdraw;
+    }
+
+    double n = stats->history_count;
+    summary->avg.clears = (Uint32)(clears / n + 0.5);
+    summary->avg.draw_calls = (Uint32)(draw_calls / n + 0.5);
+    summary->avg.texture_switches = (Uint32)(switches / n + 0.5);
+    summary->avg.sprites = (Uint32)(sprites / n + 0.5);
+    summary->avg.pixels_filled = (Uint64)(pixels / n + 0.5);
+    summary->avg.overdraw = (float)(overdraw / n);
+    summary->frame_count = stats->history_count;
+    return true;
+}
@@ -0,0 +1,384 @@
+#include "SpriteHierarchy.h"
+#include <math.h>
+
+// ========== 内部辅助函数 ==========
+// 实体 -> 节点下标（不在层级中返回 -1）
+static int node_of(const SpriteHierarchy* hierarchy, SpriteEntity entity) {
+    if (entity == SPRITE_ENTITY_INVALID) return -1;
+    Uint32 idx = entity & SPRITE_ENTITY_INDEX_MASK;
+    if (idx >= (Uint32)hierarchy->store->capacity) return -1;
+    int n = hierarchy->node_of[idx];
+    return (n >= 0 && hierarchy->nodes[n].entity == entity) ? n : -1;
+}
+
+// 把稠密下标 d 的当前变换记为节点的世界变换
+static void capture_world(SpriteAttachment* node, const SpriteStore* store, int d) {
+    node->x = store->x[d];
+    node->y = store->y[d];
+    node->scale = store->scale[d];
+    node->rotation = store->rotation[d];
+    node->flip = store->flip[d];
+}
+
+// SpriteStore 中的变换是否与记录的世界变换一致
+static bool world_matches(const SpriteAttachment* node, const SpriteStore* store, int d) {
+    return node->x == store->x[d] && node->y == store->y[d] && node->scale == store->scale[d] &&
+           node->rotation == store->rotation[d] && node->flip == store->flip[d];
+}
+
+// 查找节点，没有则作为根节点加入（追加在末尾仍是合法的先序排列）
+static int ensure_node(SpriteHierarchy* hierarchy, SpriteEntity entity, int d) {
+    int n = node_of(hierarchy, entity);
+    if (n >= 0) return n;
+    if (hierarchy->count >= hierarchy->capacity) {
+        fprintf(stderr, "SpriteHierarchy: Hierarchy full (capacity: %d)\n", hierarchy->capacity);
+        return -1;
+    }
+
+    n = hierarchy->count++;
+    SpriteAttachment* node = &hierarchy->nodes[n];
+    memset(node, 0, sizeof(SpriteAttachment));
+    node->entity = entity;
+    node->parent = -1;
+    node->anchor = -1;
+    node->local_scale = 1.0f;
+    node->frame = -1;
+    node->dirty = true;
+    capture_world(node, hierarchy->store, d);
+    hierarchy->node_of[entity & SPRITE_ENTITY_INDEX_MASK] = n;
+    hierarchy->subtree_end[n] = n + 1;
+    SpriteStore_MarkChanged(hierarchy->store, entity); // 下次 Update 记录自身的帧
+    return n;
+}
+
+// 按 remap 重建节点数组（remap[i] 为 -1 的节点丢弃），并修正父节点下标和实体索引映射
+static void apply_remap(SpriteHierarchy* hierarchy, int new_count) {
+    for (int i = 0; i < hierarchy->count; i++) {
+        int dst = hierarchy->remap[i];
+        if (dst < 0) continue;
+        hierarchy->scratch[dst] = hierarchy->nodes[i];
+        int parent = hierarchy->scratch[dst].parent;
+        hierarchy->scratch[dst].parent = parent >= 0 ? hierarchy->remap[parent] : -1;
+    }
+    memcpy(hierarchy->nodes, hierarchy->scratch, sizeof(SpriteAttachment) * new_count);
+    hierarchy->count = new_count;
+
+    for (int i = 0; i < new_count; i++) {
+        hierarchy->node_of[hierarchy->nodes[i].entity & SPRITE_ENTITY_INDEX_MASK] = i;
+    }
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int ia = *(const int*)a;
+    int ib = *(const int*)b;
+    return (ia > ib) - (ia < ib);
+}
+
+// 按先序（深度优先）重排：父节点在前，且每棵子树占据连续区间 [i, subtree_end[i])
+static void sort_preorder(SpriteHierarchy* hierarchy) {
+    int n = hierarchy->count;
+    int* first_child = hierarchy->first_child;
+    int* next_sibling = hierarchy->next_sibling;
+    int roots = -1;
+    for (int i = 0; i < n; i++) first_child[i] = -1;
+    // 倒序头插，兄弟之间保持原有相对顺序
+    for (int i = n - 1; i >= 0; i--) {
+        int p = hierarchy->nodes[i].parent;
+        int* head = p >= 0 ? &first_child[p] : &roots;
+        next_sibling[i] = *head;
+        *head = i;
+    }
+
+    // 不用栈的先序遍历：有子节点先下探，否则沿父节点回溯到还有下一个兄弟的祖先
+    int pos = 0;
+    for (int cur = roots; cur >= 0; ) {
+        SpriteAttachment* node = &hierarchy->nodes[cur];
+        node->depth = node->parent >= 0 ? hierarchy->nodes[node->parent].depth + 1 : 0;
+        hierarchy->remap[cur] = pos++;
+        if (first_child[cur] >= 0) {
+            cur = first_child[cur];
+            continue;
+        }
+        while (cur >= 0 && next_sibling[cur] < 0) cur = hierarchy->nodes[cur].parent;
+        if (cur >= 0) cur = next_sibling[cur];
+    }
+    apply_remap(hierarchy, n);
+
+    // 子节点都在父节点之后，倒序把子树末尾传给父节点
+    for (int i = 0; i < n; i++) hierarchy->subtree_end[i] = i + 1;
+    for (int i = n - 1; i >= 0; i--) {
+        int p = hierarchy->nodes[i].parent;
+        if (p >= 0 && hierarchy->subtree_end[i] > hierarchy->subtree_end[p]) {
+            hierarchy->subtree_end[p] = hierarchy->subtree_end[i];
+        }
+    }
+    hierarchy->order_dirty = false;
+}
+
+// 丢弃实体被置为无效的节点，其子节点成为根（保持当前世界变换）
+static void compact(SpriteHierarchy* hierarchy) {
+    int kept = 0;
+    for (int i = 0; i < hierarchy->count; i++) {
+        hierarchy->remap[i] = hierarchy->nodes[i].entity == SPRITE_ENTITY_INVALID ? -1 : kept++;
+    }
+    apply_remap(hierarchy, kept);
+    hierarchy->order_dirty = true;
+}
+
+// 实体索引被新实体复用而旧节点还未在 Update 中清理时，先丢弃旧节点
+static void drop_stale(SpriteHierarchy* hierarchy, SpriteEntity entity) {
+    Uint32 idx = entity & SPRITE_ENTITY_INDEX_MASK;
+    int n = hierarchy->node_of[idx];
+    if (n < 0 || hierarchy->nodes[n].entity == entity) return;
+    hierarchy->node_of[idx] = -1;
+    hierarchy->nodes[n].entity = SPRITE_ENTITY_INVALID;
+    compact(hierarchy);
+}
+
+// 由父节点世界变换和挂点计算子节点世界变换
+static void compose(SpriteAttachment* node, const SpriteAttachment* parent, const Animation* parent_anim) {
+    // 挂点相对父帧中心的偏移
+    float ox = node->local_x;
+    float oy = node->local_y;
+    if (node->anchor >= 0 && parent->frame >= 0) {
+        const SDL_Rect* rect = &parent_anim->frames[parent->frame].rect;
+        const SDL_FPoint* point = &parent_anim->anchors[node->anchor].points[parent->frame];
+        ox += point->x - rect->w / 2.0f;
+        oy += point->y - rect->h / 2.0f;
+    }
+    if (parent->flip & SDL_FLIP_HORIZONTAL) ox = -ox;
+    if (parent->flip & SDL_FLIP_VERTICAL) oy = -oy;
+    ox *= parent->scale;
+    oy *= parent->scale;
+
+    // 屏幕坐标 y 向下，与 SDL_RenderCopyEx 一样正角度为顺时针
+    float c = cosf(parent->rotation);
+    float s = sinf(parent->rotation);
+    node->x = parent->x + ox * c - oy * s;
+    node->y = parent->y + ox * s + oy * c;
+
+    // 父节点单轴翻转时局部旋转方向相反
+    bool mirrored = ((parent->flip & SDL_FLIP_HORIZONTAL) != 0) != ((parent->flip & SDL_FLIP_VERTICAL) != 0);
+    node->rotation = parent->rotation + (mirrored ? -node->local_rotation : node->local_rotation);
+    node->scale = parent->scale * node->local_scale;
+    node->flip = parent->flip ^ node->local_flip;
+}
+
+// ========== 核心接口实现 ==========
+SpriteHierarchy* SpriteHierarchy_Create(SpriteStore* store, int capacity) {
+    if (!store || capacity <= 0 || capacity > store->capacity) {
+        fprintf(stderr, "SpriteHierarchy: Invalid params for Create\n");
+        return NULL;
+    }
+
+    SpriteHierarchy* hierarchy = (SpriteHierarchy*)calloc(1, sizeof(SpriteHierarchy));
+    if (!hierarchy) {
+        fprintf(stderr, "SpriteHierarchy: Failed to allocate hierarchy\n");
+        return NULL;
+    }
+
+    hierarchy->store = store;
+    hierarchy->capacity = capacity;
+
+    size_t n = (size_t)capacity;
+    hierarchy->nodes = (SpriteAttachment*)malloc(sizeof(SpriteAttachment) * n);
+    hierarchy->node_of = (int*)malloc(sizeof(int) * (size_t)store->capacity);
+    hierarchy->dense = (int*)malloc(sizeof(int) * n);
+    hierarchy->changed = (Uint8*)malloc(sizeof(Uint8) * n);
+    hierarchy->subtree_end = (int*)malloc(sizeof(int) * n);
+    hierarchy->seeds = (int*)malloc(sizeof(int) * n);
+    hierarchy->first_child = (int*)malloc(sizeof(int) * n);
+    hierarchy->next_sibling = (int*)malloc(sizeof(int) * n);
+    hierarchy->scratch = (SpriteAttachment*)malloc(sizeof(SpriteAttachment) * n);
+    hierarchy->remap = (int*)malloc(sizeof(int) * n);
+    if (!hierarchy->nodes || !hierarchy->node_of || !hierarchy->dense || !hierarchy->changed ||
+        !hierarchy->subtree_end || !hierarchy->seeds || !hierarchy->first_child || !hierarchy->next_sibling ||
+        !hierarchy->scratch || !hierarchy->remap) {
+        fprintf(stderr, "SpriteHierarchy: Failed to allocate node arrays\n");
+        SpriteHierarchy_Destroy(hierarchy);
+        return NULL;
+    }
+    memset(hierarchy->node_of, 0xFF, sizeof(int) * (size_t)store->capacity);
+
+    printf("SpriteHierarchy: Created (capacity: %d)\n", capacity);
+    return hierarchy;
+}
+
+bool SpriteHierarchy_Attach(SpriteHierarchy* hierarchy, SpriteEntity child, SpriteEntity parent, const char* anchor_name, float local_x, float local_y) {
+    if (!hierarchy || child == parent) {
+        fprintf(stderr, "SpriteHierarchy: Invalid params for Attach\n");
+        return false;
+    }
+
+    SpriteStore* store = hierarchy->store;
+    int dc = SpriteStore_DenseIndex(store, child);
+    int dp = SpriteStore_DenseIndex(store, parent);
+    if (dc < 0 || dp < 0) {
+        fprintf(stderr, "SpriteHierarchy: Attach on dead entity\n");
+        return false;
+    }
+
+    int anchor = -1;
+    if (anchor_name) {
+        anchor = AnimationManager_FindAnchor(store->anim[dp], anchor_name);
+        if (anchor < 0) {
+            fprintf(stderr, "SpriteHierarchy: Anchor '%s' not found\n", anchor_name);
+            return false;
+        }
+    }
+
+    drop_stale(hierarchy, child);
+    drop_stale(hierarchy, parent);
+
+    // 父节点不能位于子节点的子树中
+    int cn = node_of(hierarchy, child);
+    for (int p = node_of(hierarchy, parent); cn >= 0 && p >= 0; p = hierarchy->nodes[p].parent) {
+        if (p == cn) {
+            fprintf(stderr, "SpriteHierarchy: Attach would create a cycle\n");
+            return false;
+        }
+    }
+
+    int pn = ensure_node(hierarchy, parent, dp);
+    if (pn < 0) return false;
+    cn = ensure_node(hierarchy, child, dc);
+    if (cn < 0) return false;
+
+    SpriteAttachment* node = &hierarchy->nodes[cn];
+    if (node->parent != pn) hierarchy->order_dirty = true;
+    node->parent = pn;
+    node->anchor = anchor;
+    node->local_x = local_x;
+    node->local_y = local_y;
+    node->dirty = true;
+    SpriteStore_MarkChanged(store, child);
+    return true;
+}
+
+void SpriteHierarchy_SetLocal(SpriteHierarchy* hierarchy, SpriteEntity child, float local_x, float local_y, float scale, float rotation, SDL_RendererFlip flip) {
+    if (!hierarchy) return;
+    int n = node_of(hierarchy, child);
+    if (n < 0 || hierarchy->nodes[n].parent < 0) return;
+
+    SpriteAttachment* node = &hierarchy->nodes[n];
+    node->local_x = local_x;
+    node->local_y = local_y;
+    node->local_scale = scale;
+    node->local_rotation = rotation;
+    node->local_flip = (Uint8)flip;
+    node->dirty = true;
+    SpriteStore_MarkChanged(hierarchy->store, child);
+}
+
+void SpriteHierarchy_Detach(SpriteHierarchy* hierarchy, SpriteEntity entity) {
+    if (!hierarchy) return;
+    int n = node_of(hierarchy, entity);
+    if (n < 0 || hierarchy->nodes[n].parent < 0) return;
+
+    hierarchy->nodes[n].parent = -1;
+    hierarchy->nodes[n].dirty = true;
+    hierarchy->order_dirty = true;
+    SpriteStore_MarkChanged(hierarchy->store, entity);
+}
+
+void SpriteHierarchy_Remove(SpriteHierarchy* hierarchy, SpriteEntity entity) {
+    if (!hierarchy) return;
+    int n = node_of(hierarchy, entity);
+    if (n < 0) return;
+
+    hierarchy->node_of[entity & SPRITE_ENTITY_INDEX_MASK] = -1;
+    hierarchy->nodes[n].entity = SPRITE_ENTITY_INVALID;
+    compact(hierarchy);
+}
+
+void SpriteHierarchy_Update(SpriteHierarchy* hierarchy) {
+    if (!hierarchy) return;
+    if (hierarchy->order_dirty) sort_preorder(hierarchy);
+
+    // SpriteStore 登记了变更的节点作为种子（变更列表按实体索引去重，每个节点至多一次）
+    SpriteStore* store = hierarchy->store;
+    int seed_count = 0;
+    for (int k = 0; k < store->changed_count; k++) {
+        int n = hierarchy->node_of[store->changed[k]];
+        if (n < 0) continue;
+        hierarchy->nodes[n].dirty = true;
+        hierarchy->seeds[seed_count++] = n;
+    }
+    SpriteStore_ClearChanged(store);
+    qsort(hierarchy->seeds, seed_count, sizeof(int), compare_ints);
+
+    bool any_dead = false;
+    int recomputed = 0;
+    int visited = 0;
+    int covered = 0;
+
+    // 只遍历种子所在的子树；落在前一棵子树内的种子已随之处理
+    for (int k = 0; k < seed_count; k++) {
+        int start = hierarchy->seeds[k];
+        if (start < covered) continue;
+        covered = hierarchy->subtree_end[start];
+        visited += covered - start;
+
+        // 先序：处理到子节点时父节点本次的世界变换和帧已确定
+        for (int i = start; i < covered; i++) {
+            SpriteAttachment* node = &hierarchy->nodes[i];
+            int d = SpriteStore_DenseIndex(store, node->entity);
+            hierarchy->dense[i] = d;
+            if (d < 0) {
+                // 实体已销毁：子节点本次保持不动，之后成为根
+                hierarchy->node_of[node->entity & SPRITE_ENTITY_INDEX_MASK] = -1;
+                node->entity = SPRITE_ENTITY_INVALID;
+                hierarchy->changed[i] = 0;
+                any_dead = true;
+                continue;
+            }
+
+            // 子树根的父节点不在本区间内，未登记变更，记录的世界变换和帧仍有效
+            int frame = SpriteStore_FrameAt(store, d);
+            int p = node->parent;
+            int dp = p < 0 ? -1 : (p >= start ? hierarchy->dense[p] : SpriteStore_DenseIndex(store, hierarchy->nodes[p].entity));
+            bool moved;
+            if (dp < 0) {
+                // 根：由 SpriteStore 驱动，只检测变化
+                moved = node->dirty || !world_matches(node, store, d);
+                if (moved) capture_world(node, store, d);
+            } else {
+                moved = node->dirty || (p >= start && hierarchy->changed[p]) || !world_matches(node, store, d);
+                if (moved) {
+                    compose(node, &hierarchy->nodes[p], store->anim[dp]);
+                    store->x[d] = node->x;
+                    store->y[d] = node->y;
+                    store->scale[d] = node->scale;
+                    store->rotation[d] = node->rotation;
+                    store->flip[d] = node->flip;
+                    recomputed++;
+                }
+            }
+            hierarchy->changed[i] = moved || frame != node->frame;
+            node->frame = frame;
+            node->dirty = false;
+        }
+    }
+
+    hierarchy->recomputed = recomputed;
+    hierarchy->visited = visited;
+    if (any_dead) compact(hierarchy);
+}
+
+void SpriteHierarchy_Destroy(SpriteHierarchy* hierarchy) {
+    if (!hierarchy) return;
+
+    free(hierarchy->nodes);
+    free(hierarchy->node_of);
+    free(hierarchy->dense);
+    free(hierarchy->changed);
+    free(hierarchy->subtree_end);
+    free(hierarchy->seeds);
+    free(hierarchy->first_child);
+    free(hierarchy->next_sibling);
+    free(hierarchy->scratch);
+    free(hierarchy->remap);
+    free(hierarchy);
+
+    printf("SpriteHierarchy: Destroyed\n");
+}
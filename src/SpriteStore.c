@@ -0,0 +1,526 @@
+#include "SpriteStore.h"
+#include "RenderQueue.h"
+#include <math.h>
+
+#define INVALID_DENSE 0xFFFFFFFFu
+
+// ========== 内部辅助函数 ==========
+static Uint32 entity_index(SpriteEntity entity) {
+    return entity & SPRITE_ENTITY_INDEX_MASK;
+}
+
+static Uint8 entity_generation(SpriteEntity entity) {
+    return (Uint8)(entity >> SPRITE_ENTITY_INDEX_BITS);
+}
+
+// 句柄 -> 稠密下标（无效返回 -1）
+static int dense_of(const SpriteStore* store, SpriteEntity entity) {
+    if (!store || entity == SPRITE_ENTITY_INVALID) return -1;
+    Uint32 idx = entity_index(entity);
+    if (idx >= (Uint32)store->next_index) return -1;
+    if (store->generation[idx] != entity_generation(entity)) return -1;
+    Uint32 dense = store->sparse[idx];
+    return dense == INVALID_DENSE ? -1 : (int)dense;
+}
+
+// 把稠密下标 src 的全部组件拷贝到 dst
+static void move_dense(SpriteStore* store, int dst, int src) {
+    store->entities[dst] = store->entities[src];
+    store->x[dst] = store->x[src];
+    store->y[dst] = store->y[src];
+    store->vx[dst] = store->vx[src];
+    store->vy[dst] = store->vy[src];
+    store->scale[dst] = store->scale[src];
+    store->rotation[dst] = store->rotation[src];
+    store->layer[dst] = store->layer[src];
+    store->flip[dst] = store->flip[src];
+    store->palette[dst] = store->palette[src];
+    store->anim[dst] = store->anim[src];
+    store->clip[dst] = store->clip[src];
+    store->elapsed[dst] = store->elapsed[src];
+    store->speed[dst] = store->speed[src];
+    store->cursor[dst] = store->cursor[src];
+    store->playing[dst] = store->playing[src];
+    store->sparse[entity_index(store->entities[dst])] = (Uint32)dst;
+}
+
+static int compare_sort_keys(const void* a, const void* b) {
+    Uint64 ka = *(const Uint64*)a;
+    Uint64 kb = *(const Uint64*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+// 按 order 重排一个稠密数组（借助 scratch）
+static void permute_array(void* base, size_t elem_size, const Uint64* order, int count, void* scratch) {
+    Uint8* src = (Uint8*)base;
+    Uint8* dst = (Uint8*)scratch;
+    for (int i = 0; i < count; i++) {
+        memcpy(dst + i * elem_size, src + (Uint32)order[i] * elem_size, elem_size);
+    }
+    memcpy(base, scratch, elem_size * count);
+}
+
+// 按 layer 稳定排序稠密数组（key = layer 高 32 位 + 原下标低 32 位）
+static void sort_by_layer(SpriteStore* store) {
+    int n = store->count;
+    bool sorted = true;
+    for (int i = 0; i < n; i++) {
+        store->sort_keys[i] = ((Uint64)((Uint32)store->layer[i] ^ 0x80000000u) << 32) | (Uint32)i;
+        if (i > 0 && store->layer[i] < store->layer[i - 1]) sorted = false;
+    }
+    store->order_dirty = false;
+    if (sorted) return;
+
+    qsort(store->sort_keys, n, sizeof(Uint64), compare_sort_keys);
+
+    permute_array(store->entities, sizeof(SpriteEntity), store->sort_keys, n, store->scratch);
+    permute_array(store->x, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->y, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->vx, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->vy, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->scale, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->rotation, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->layer, sizeof(int), store->sort_keys, n, store->scratch);
+    permute_array(store->flip, sizeof(Uint8), store->sort_keys, n, store->scratch);
+    permute_array(store->palette, sizeof(SpritePalette*), store->sort_keys, n, store->scratch);
+    permute_array(store->anim, sizeof(Animation*), store->sort_keys, n, store->scratch);
+    permute_array(store->clip, sizeof(AnimationClip*), store->sort_keys, n, store->scratch);
+    permute_array(store->elapsed, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->speed, sizeof(float), store->sort_keys, n, store->scratch);
+    permute_array(store->cursor, sizeof(int), store->sort_keys, n, store->scratch);
+    permute_array(store->playing, sizeof(Uint8), store->sort_keys, n, store->scratch);
+
+    for (int i = 0; i < n; i++) {
+        store->sparse[entity_index(store->entities[i])] = (Uint32)i;
+    }
+}
+
+// 把实体索引登记到变更列表（已登记则忽略）
+static void mark_changed(SpriteStore* store, Uint32 idx) {
+    if (store->changed_flag[idx]) return;
+    store->changed_flag[idx] = 1;
+    store->changed[store->changed_count++] = idx;
+}
+
+// 稠密下标 d 当前帧索引
+static int current_frame(const SpriteStore* store, int d) {
+    const AnimationClip* clip = store->clip[d];
+    return clip ? clip->frame_indices[store->cursor[d]] : 0;
+}
+
+// 稠密下标 d 的绘制目标矩形（居中绘制，与 AnimationManager_Draw 一致）
+static SDL_Rect dst_rect_of(const SpriteStore* store, int d, const SDL_Rect* src_rect) {
+    SDL_Rect dst_rect;
+    dst_rect.w = (int)(src_rect->w * store->scale[d]);
+    dst_rect.h = (int)(src_rect->h * store->scale[d]);
+    dst_rect.x = (int)store->x[d] - dst_rect.w / 2;
+    dst_rect.y = (int)store->y[d] - dst_rect.h / 2;
+    return dst_rect;
+}
+
+// 屏幕坐标 p（不小于 origin）之后第一个映射到下一纹素的坐标（与 hit_dense 的换算一致）
+static int next_texel_edge(int p, int origin, int src_size, int dst_size) {
+    Sint64 local = (Sint64)(p - origin) * src_size / dst_size;
+    return origin + (int)(((local + 1) * dst_size + src_size - 1) / src_size);
+}
+
+// 屏幕点是否落在稠密下标 d 的不透明像素上
+static bool hit_dense(const SpriteStore* store, int d, int px, int py) {
+    const Animation* anim = store->anim[d];
+    if (!anim->frames) return false;
+
+    int frame_idx = current_frame(store, d);
+    const SDL_Rect* src_rect = &anim->frames[frame_idx].rect;
+    SDL_Rect dst = dst_rect_of(store, d, src_rect);
+    if (px < dst.x || py < dst.y || px >= dst.x + dst.w || py >= dst.y + dst.h) return false;
+
+    // 屏幕坐标 -> 帧内坐标（按实际绘制尺寸换算，避免缩放取整误差越界）
+    int local_x = (int)((Sint64)(px - dst.x) * src_rect->w / dst.w);
+    int local_y = (int)((Sint64)(py - dst.y) * src_rect->h / dst.h);
+    return AnimationManager_FrameHitTest(anim, frame_idx, local_x, local_y, (SDL_RendererFlip)store->flip[d]);
+}
+
+// 查找动画序列（与 AnimationManager 相同的按名查找）
+static AnimationClip* find_clip(Animation* anim, const char* clip_name) {
+    for (int i = 0; i < anim->clip_count; i++) {
+        if (strcmp(anim->clips[i]->name, clip_name) == 0) {
+            return anim->clips[i];
+        }
+    }
+    return NULL;
+}
+
+// ========== 核心接口实现 ==========
+SpriteStore* SpriteStore_Create(AnimationManager* anim_manager, int capacity) {
+    if (!anim_manager || capacity <= 0 || capacity > SPRITE_STORE_MAX_CAPACITY) {
+        fprintf(stderr, "SpriteStore: Invalid params for Create\n");
+        return NULL;
+    }
+
+    SpriteStore* store = (SpriteStore*)calloc(1, sizeof(SpriteStore));
+    if (!store) {
+        fprintf(stderr, "SpriteStore: Failed to allocate store\n");
+        return NULL;
+    }
+
+    store->capacity = capacity;
+    store->anim_manager = anim_manager;
+    store->renderer = anim_manager->renderer;
+    store->stats = anim_manager->stats;
+
+    size_t n = (size_t)capacity;
+    store->sparse = (Uint32*)malloc(sizeof(Uint32) * n);
+    store->generation = (Uint8*)calloc(n, sizeof(Uint8));
+    store->free_indices = (Uint32*)malloc(sizeof(Uint32) * n);
+    store->entities = (SpriteEntity*)malloc(sizeof(SpriteEntity) * n);
+    store->x = (float*)malloc(sizeof(float) * n);
+    store->y = (float*)malloc(sizeof(float) * n);
+    store->vx = (float*)malloc(sizeof(float) * n);
+    store->vy = (float*)malloc(sizeof(float) * n);
+    store->scale = (float*)malloc(sizeof(float) * n);
+    store->rotation = (float*)malloc(sizeof(float) * n);
+    store->layer = (int*)malloc(sizeof(int) * n);
+    store->flip = (Uint8*)malloc(sizeof(Uint8) * n);
+    store->palette = (SpritePalette**)malloc(sizeof(SpritePalette*) * n);
+    store->anim = (Animation**)malloc(sizeof(Animation*) * n);
+    store->clip = (AnimationClip**)malloc(sizeof(AnimationClip*) * n);
+    store->elapsed = (float*)malloc(sizeof(float) * n);
+    store->speed = (float*)malloc(sizeof(float) * n);
+    store->cursor = (int*)malloc(sizeof(int) * n);
+    store->playing = (Uint8*)malloc(sizeof(Uint8) * n);
+    store->sort_keys = (Uint64*)malloc(sizeof(Uint64) * n);
+    store->scratch = malloc(sizeof(Uint64) * n); // 可容纳最大组件（指针）
+    store->changed = (Uint32*)malloc(sizeof(Uint32) * n);
+    store->changed_flag = (Uint8*)calloc(n, sizeof(Uint8));
+
+    if (!store->sparse || !store->generation || !store->free_indices || !store->entities ||
+        !store->x || !store->y || !store->vx || !store->vy || !store->scale || !store->rotation ||
+        !store->layer || !store->flip || !store->palette || !store->anim || !store->clip || !store->elapsed ||
+        !store->speed || !store->cursor || !store->playing || !store->sort_keys || !store->scratch ||
+        !store->changed || !store->changed_flag) {
+        fprintf(stderr, "SpriteStore: Failed to allocate component arrays\n");
+        SpriteStore_Destroy(store);
+        return NULL;
+    }
+
+    printf("SpriteStore: Created (capacity: %d)\n", capacity);
+    return store;
+}
+
+SpriteEntity SpriteStore_CreateEntity(SpriteStore* store, Animation* anim, float x, float y) {
+    if (!store || !anim) return SPRITE_ENTITY_INVALID;
+    if (store->count >= store->capacity) {
+        fprintf(stderr, "SpriteStore: Store full (capacity: %d)\n", store->capacity);
+        return SPRITE_ENTITY_INVALID;
+    }
+
+    // 优先复用回收的索引
+    Uint32 idx = store->free_count > 0 ? store->free_indices[--store->free_count] : (Uint32)store->next_index++;
+    SpriteEntity entity = ((Uint32)store->generation[idx] << SPRITE_ENTITY_INDEX_BITS) | idx;
+
+    int d = store->count++;
+    store->sparse[idx] = (Uint32)d;
+    store->entities[d] = entity;
+    store->x[d] = x;
+    store->y[d] = y;
+    store->vx[d] = 0.0f;
+    store->vy[d] = 0.0f;
+    store->scale[d] = 1.0f;
+    store->rotation[d] = 0.0f;
+    store->layer[d] = 0;
+    store->flip[d] = SDL_FLIP_NONE;
+    store->palette[d] = NULL;
+    store->anim[d] = anim;
+    store->clip[d] = NULL;
+    store->elapsed[d] = 0.0f;
+    store->speed[d] = 1.0f;
+    store->cursor[d] = 0;
+    store->playing[d] = 0;
+
+    // 新实体 layer 为 0，只有末尾 layer 大于 0 时才破坏顺序
+    if (d > 0 && store->layer[d - 1] > 0) store->order_dirty = true;
+    return entity;
+}
+
+bool SpriteStore_DestroyEntity(SpriteStore* store, SpriteEntity entity) {
+    int d = dense_of(store, entity);
+    if (d < 0) return false;
+
+    Uint32 idx = entity_index(entity);
+    int last = --store->count;
+    if (d != last) {
+        if (store->layer[d] != store->layer[last]) store->order_dirty = true;
+        move_dense(store, d, last);
+    }
+
+    store->sparse[idx] = INVALID_DENSE;
+    store->generation[idx]++;
+    mark_changed(store, idx);
+    store->free_indices[store->free_count++] = idx;
+    return true;
+}
+
+bool SpriteStore_IsAlive(const SpriteStore* store, SpriteEntity entity) {
+    return dense_of(store, entity) >= 0;
+}
+
+void SpriteStore_SetPosition(SpriteStore* store, SpriteEntity entity, float x, float y) {
+    int d = dense_of(store, entity);
+    if (d < 0 || (store->x[d] == x && store->y[d] == y)) return;
+    store->x[d] = x;
+    store->y[d] = y;
+    mark_changed(store, entity_index(entity));
+}
+
+void SpriteStore_SetVelocity(SpriteStore* store, SpriteEntity entity, float vx, float vy) {
+    int d = dense_of(store, entity);
+    if (d < 0) return;
+    store->vx[d] = vx;
+    store->vy[d] = vy;
+}
+
+void SpriteStore_SetTransform(SpriteStore* store, SpriteEntity entity, float scale, float rotation, SDL_RendererFlip flip) {
+    int d = dense_of(store, entity);
+    if (d < 0 || (store->scale[d] == scale && store->rotation[d] == rotation && store->flip[d] == (Uint8)flip)) return;
+    store->scale[d] = scale;
+    store->rotation[d] = rotation;
+    store->flip[d] = (Uint8)flip;
+    mark_changed(store, entity_index(entity));
+}
+
+void SpriteStore_SetLayer(SpriteStore* store, SpriteEntity entity, int layer) {
+    int d = dense_of(store, entity);
+    if (d < 0 || store->layer[d] == layer) return;
+    store->layer[d] = layer;
+    store->order_dirty = true;
+}
+
+void SpriteStore_SetSpeed(SpriteStore* store, SpriteEntity entity, float speed) {
+    int d = dense_of(store, entity);
+    if (d < 0 || speed <= 0) return;
+    store->speed[d] = speed;
+}
+
+void SpriteStore_SetPalette(SpriteStore* store, SpriteEntity entity, SpritePalette* palette) {
+    int d = dense_of(store, entity);
+    if (d < 0) return;
+    store->palette[d] = palette;
+}
+
+bool SpriteStore_Play(SpriteStore* store, SpriteEntity entity, const char* clip_name) {
+    int d = dense_of(store, entity);
+    if (d < 0 || !clip_name) return false;
+
+    AnimationClip* clip = find_clip(store->anim[d], clip_name);
+    if (!clip) {
+        fprintf(stderr, "SpriteStore: Clip '%s' not found\n", clip_name);
+        return false;
+    }
+
+    AnimationManager_PrepareClip(store->anim_manager, store->anim[d], clip);
+    store->clip[d] = clip;
+    store->elapsed[d] = 0.0f;
+    store->cursor[d] = clip->reverse ? clip->frame_count - 1 : 0;
+    store->playing[d] = 1;
+    mark_changed(store, entity_index(entity));
+    return true;
+}
+
+void SpriteStore_Update(SpriteStore* store, float dt) {
+    if (!store || dt <= 0) return;
+
+    int n = store->count;
+
+    // 运动积分：纯浮点数组遍历，可被编译器向量化
+    float* restrict x = store->x;
+    float* restrict y = store->y;
+    const float* restrict vx = store->vx;
+    const float* restrict vy = store->vy;
+    for (int i = 0; i < n; i++) x[i] += vx[i] * dt;
+    for (int i = 0; i < n; i++) y[i] += vy[i] * dt;
+    for (int i = 0; i < n; i++) {
+        if (vx[i] != 0.0f || vy[i] != 0.0f) mark_changed(store, entity_index(store->entities[i]));
+    }
+
+    // 动画推进（规则与 AnimationManager_Update 一致）
+    for (int i = 0; i < n; i++) {
+        AnimationClip* clip = store->clip[i];
+        if (!store->playing[i] || !clip) continue;
+
+        store->elapsed[i] += dt * store->speed[i];
+        if (store->elapsed[i] < clip->frame_duration) continue;
+        store->elapsed[i] -= clip->frame_duration;
+
+        int step = clip->reverse ? -1 : 1;
+        int cursor = store->cursor[i] + step;
+        if (cursor < 0 || cursor >= clip->frame_count) {
+            if (clip->loop) {
+                cursor = clip->reverse ? clip->frame_count - 1 : 0;
+            } else {
+                cursor -= step;
+                store->playing[i] = 0;
+            }
+        }
+        if (clip->frame_indices[cursor] != clip->frame_indices[store->cursor[i]]) {
+            mark_changed(store, entity_index(store->entities[i]));
+        }
+        store->cursor[i] = cursor;
+    }
+}
+
+void SpriteStore_DrawAll(SpriteStore* store) {
+    if (!store) return;
+    if (store->order_dirty) sort_by_layer(store);
+
+    struct RenderQueue* queue = store->anim_manager ? store->anim_manager->queue : NULL;
+    int n = store->count;
+    for (int i = 0; i < n; i++) {
+        Animation* anim = store->anim[i];
+        if (!anim->frames) continue;
+
+        const AnimationFrame* frame = &anim->frames[current_frame(store, i)];
+        if (queue) { // 使用渲染线程：只录制命令
+            SDL_Rect dst_rect = dst_rect_of(store, i, &frame->src);
+            RenderQueue_Push(queue, anim, frame->tile, store->palette[i], &frame->src, &dst_rect, store->rotation[i] * 180 / M_PI, (SDL_RendererFlip)store->flip[i]);
+            RenderStats_RecordDraw(store->stats, &anim->tiles[frame->tile], &dst_rect);
+            continue;
+        }
+        if (anim->index_sheet) { // 索引动画：按实体调色板解析颜色
+            SDL_Rect dst_rect = dst_rect_of(store, i, &frame->src);
+            PaletteManager_Draw(store->anim_manager->palettes, anim, frame->tile, store->palette[i], &frame->src, &dst_rect, store->rotation[i] * 180 / M_PI, (SDL_RendererFlip)store->flip[i]);
+            RenderStats_RecordDraw(store->stats, &anim->tiles[frame->tile], &dst_rect);
+            continue;
+        }
+
+        SDL_Texture* texture = anim->tiles[frame->tile].texture;
+        if (!texture) continue; // 分块尚未上传（实体未播放过用到它的序列）
+        SDL_Rect dst_rect = dst_rect_of(store, i, &frame->src);
+
+        SDL_RenderCopyEx(
+            store->renderer,
+            texture,
+            &frame->src,
+            &dst_rect,
+            store->rotation[i] * 180 / M_PI,
+            NULL,
+            (SDL_RendererFlip)store->flip[i]
+        );
+        RenderStats_RecordDraw(store->stats, texture, &dst_rect);
+    }
+}
+
+SpriteEntity SpriteStore_HitTest(SpriteStore* store, int px, int py) {
+    if (!store) return SPRITE_ENTITY_INVALID;
+    if (store->order_dirty) sort_by_layer(store);
+
+    // 从最上层（最后绘制）往下找
+    for (int i = store->count - 1; i >= 0; i--) {
+        if (hit_dense(store, i, px, py)) return store->entities[i];
+    }
+    return SPRITE_ENTITY_INVALID;
+}
+
+bool SpriteStore_Overlap(SpriteStore* store, SpriteEntity a, SpriteEntity b) {
+    int da = dense_of(store, a);
+    int db = dense_of(store, b);
+    if (da < 0 || db < 0 || da == db) return false;
+
+    const Animation* anim_a = store->anim[da];
+    const Animation* anim_b = store->anim[db];
+    if (!anim_a->frames || !anim_b->frames) return false;
+
+    int frame_a = current_frame(store, da);
+    int frame_b = current_frame(store, db);
+    SDL_Rect dst_a = dst_rect_of(store, da, &anim_a->frames[frame_a].rect);
+    SDL_Rect dst_b = dst_rect_of(store, db, &anim_b->frames[frame_b].rect);
+
+    // 包围盒粗筛
+    SDL_Rect overlap;
+    overlap.x = dst_a.x > dst_b.x ? dst_a.x : dst_b.x;
+    overlap.y = dst_a.y > dst_b.y ? dst_a.y : dst_b.y;
+    overlap.w = (dst_a.x + dst_a.w < dst_b.x + dst_b.w ? dst_a.x + dst_a.w : dst_b.x + dst_b.w) - overlap.x;
+    overlap.h = (dst_a.y + dst_a.h < dst_b.y + dst_b.h ? dst_a.y + dst_a.h : dst_b.y + dst_b.h) - overlap.y;
+    if (overlap.w <= 0 || overlap.h <= 0) return false;
+
+    // 同一整数缩放且屏幕偏移是整纹素：两边纹素网格对齐，在掩码空间按 64 位字 AND
+    float scale = store->scale[da];
+    int texel = (int)scale;
+    if (scale == store->scale[db] && texel >= 1 && scale == (float)texel) {
+        int ox = dst_b.x - dst_a.x;
+        int oy = dst_b.y - dst_a.y;
+        if (ox % texel == 0 && oy % texel == 0) {
+            return AnimationManager_FrameOverlap(
+                anim_a, frame_a, (SDL_RendererFlip)store->flip[da],
+                anim_b, frame_b, (SDL_RendererFlip)store->flip[db],
+                ox / texel, oy / texel
+            );
+        }
+    }
+
+    // 其余情况（不同缩放、非整数缩放或纹素网格错开）：重叠区域按两边纹素边界切成小格，
+    // 格内两边命中的纹素都不变，每格采样一次即与逐像素等价
+    for (int y = overlap.y; y < overlap.y + overlap.h; ) {
+        for (int x = overlap.x; x < overlap.x + overlap.w; ) {
+            if (hit_dense(store, da, x, y) && hit_dense(store, db, x, y)) return true;
+            int next_a = next_texel_edge(x, dst_a.x, anim_a->frames[frame_a].rect.w, dst_a.w);
+            int next_b = next_texel_edge(x, dst_b.x, anim_b->frames[frame_b].rect.w, dst_b.w);
+            x = next_a < next_b ? next_a : next_b;
+        }
+        int next_a = next_texel_edge(y, dst_a.y, anim_a->frames[frame_a].rect.h, dst_a.h);
+        int next_b = next_texel_edge(y, dst_b.y, anim_b->frames[frame_b].rect.h, dst_b.h);
+        y = next_a < next_b ? next_a : next_b;
+    }
+    return false;
+}
+
+int SpriteStore_DenseIndex(const SpriteStore* store, SpriteEntity entity) {
+    return dense_of(store, entity);
+}
+
+int SpriteStore_FrameAt(const SpriteStore* store, int dense) {
+    if (!store || dense < 0 || dense >= store->count) return -1;
+    return current_frame(store, dense);
+}
+
+void SpriteStore_MarkChanged(SpriteStore* store, SpriteEntity entity) {
+    int d = dense_of(store, entity);
+    if (d < 0) return;
+    mark_changed(store, entity_index(entity));
+}
+
+void SpriteStore_ClearChanged(SpriteStore* store) {
+    if (!store) return;
+    for (int i = 0; i < store->changed_count; i++) store->changed_flag[store->changed[i]] = 0;
+    store->changed_count = 0;
+}
+
+void SpriteStore_Destroy(SpriteStore* store) {
+    if (!store) return;
+
+    free(store->sparse);
+    free(store->generation);
+    free(store->free_indices);
+    free(store->entities);
+    free(store->x);
+    free(store->y);
+    free(store->vx);
+    free(store->vy);
+    free(store->scale);
+    free(store->rotation);
+    free(store->layer);
+    free(store->flip);
+    free(store->palette);
+    free(store->anim);
+    free(store->clip);
+    free(store->elapsed);
+    free(store->speed);
+    free(store->cursor);
+    free(store->playing);
+    free(store->sort_keys);
+    free(store->scratch);
+    free(store->changed);
+    free(store->changed_flag);
+    free(store);
+
+    printf("SpriteStore: Destroyed\n");
+}
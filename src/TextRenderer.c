@@ -0,0 +1,346 @@
+#include "TextRenderer.h"
+#include "RenderQueue.h"
+
+// ========== 内部辅助函数 ==========
+static Uint32 hash_text(const char* str, float scale) {
+    Uint32 h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    Uint32 scale_bits;
+    memcpy(&scale_bits, &scale, sizeof(scale_bits));
+    h ^= scale_bits * 2654435761u;
+    return (h ^ (h >> 16)) % TEXT_CACHE_BUCKETS;
+}
+
+static void free_entry(TextRenderer* text, TextCacheEntry* entry) {
+    free(entry->text);
+    free(entry->vertices);
+    free(entry->batches);
+    free(entry);
+    text->entry_count--;
+}
+
+// 按 Alpha 掩码测量字形左右空白（全透明字形视为空格，步进取半格）
+static void measure_glyphs(TextRenderer* text) {
+    for (int g = 0; g < text->glyph_count; g++) {
+        int left = -1;
+        int right = -1;
+        for (int col = 0; col < text->cell_w; col++) {
+            for (int row = 0; row < text->cell_h; row++) {
+                if (AnimationManager_FrameHitTest(text->atlas, g, col, row, SDL_FLIP_NONE)) {
+                    if (left < 0) left = col;
+                    right = col;
+                    break;
+                }
+            }
+        }
+        if (left < 0) {
+            text->glyph_left[g] = 0;
+            text->glyph_advance[g] = (text->cell_w + 1) / 2;
+        } else {
+            // 字形之间留 1 像素间距
+            text->glyph_left[g] = left;
+            text->glyph_advance[g] = right - left + 2;
+        }
+    }
+}
+
+// 把 str 排版进 layout/quad_tile（左上角为 (x, y)，out 为 false 时只测量），返回字形数（最多 capacity 个）；w/h 为排版尺寸
+static int layout(
+    TextRenderer* text, const char* str, float scale, float x, float y,
+    SDL_Color color, bool out, int* w, int* h
+) {
+    const float glyph_w = text->cell_w * scale;
+    const float line_h = text->cell_h * scale;
+    float pen_x = x;
+    float pen_y = y;
+    float max_w = 0.0f;
+    int quads = 0;
+
+    for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+        if (*p == '\n') {
+            if (pen_x - x > max_w) max_w = pen_x - x;
+            pen_x = x;
+            pen_y += line_h;
+            continue;
+        }
+        int g = (int)*p - text->first_char;
+        if (g < 0 || g >= text->glyph_count) {
+            // 字形表外的字符按空白处理
+            pen_x += glyph_w;
+            continue;
+        }
+
+        if (out && quads < text->capacity) {
+            const float* uv = &text->glyph_uv[g * 4];
+            float x0 = pen_x - text->glyph_left[g] * scale;
+            float x1 = x0 + glyph_w;
+            float y1 = pen_y + line_h;
+            SDL_Vertex* v = &text->layout[quads * 4];
+            v[0] = (SDL_Vertex){ { x0, pen_y }, color, { uv[0], uv[1] } };
+            v[1] = (SDL_Vertex){ { x1, pen_y }, color, { uv[2], uv[1] } };
+            v[2] = (SDL_Vertex){ { x0, y1 }, color, { uv[0], uv[3] } };
+            v[3] = (SDL_Vertex){ { x1, y1 }, color, { uv[2], uv[3] } };
+            text->quad_tile[quads] = text->atlas->frames[g].tile;
+            quads++;
+        }
+        pen_x += text->glyph_advance[g] * scale;
+    }
+    if (pen_x - x > max_w) max_w = pen_x - x;
+
+    if (w) *w = (int)(max_w + 0.5f);
+    if (h) *h = (int)(pen_y - y + line_h + 0.5f);
+    return quads;
+}
+
+// 把排版缓冲中的 quads 个字形按所在分块计数排序进提交缓冲，并生成批次
+static void group_by_tile(TextRenderer* text, int quads) {
+    int tile_count = text->atlas->tile_count;
+    memset(text->tile_quads, 0, sizeof(int) * tile_count);
+    for (int q = 0; q < quads; q++) {
+        text->tile_quads[text->quad_tile[q]]++;
+    }
+
+    text->batch_count = 0;
+    int offset = 0;
+    for (int t = 0; t < tile_count; t++) {
+        int count = text->tile_quads[t];
+        if (count == 0) continue;
+        text->batches[text->batch_count++] = (TextBatch){ t, offset, count };
+        text->tile_quads[t] = offset;
+        offset += count;
+    }
+
+    for (int q = 0; q < quads; q++) {
+        int dst = text->tile_quads[text->quad_tile[q]]++;
+        memcpy(&text->vertices[dst * 4], &text->layout[q * 4], sizeof(SDL_Vertex) * 4);
+    }
+}
+
+// 提交缓冲中的字形（每个批次一次几何绘制）
+static void submit(TextRenderer* text, const TextBatch* batches, int batch_count, float scale) {
+    // 使用渲染线程时字形表纹理归渲染线程所有，这里不读取
+    struct RenderQueue* queue = text->anim_manager->queue;
+    Uint64 glyph_pixels = (Uint64)(text->cell_w * scale) * (Uint64)(text->cell_h * scale);
+
+    for (int b = 0; b < batch_count; b++) {
+        const TextBatch* batch = &batches[b];
+        AnimationTile* tile = &text->atlas->tiles[batch->tile];
+        SDL_Vertex* vertices = text->vertices + batch->first_quad * 4;
+        if (queue) {
+            RenderQueue_PushGeometry(queue, text->atlas, batch->tile, vertices, batch->quad_count);
+            RenderStats_RecordBatch(text->stats, tile, batch->quad_count, glyph_pixels * batch->quad_count);
+            continue;
+        }
+        if (!tile->texture) continue;
+        if (SDL_RenderGeometry(text->renderer, tile->texture, vertices, batch->quad_count * 4, text->indices, batch->quad_count * 6) != 0) {
+            fprintf(stderr, "TextRenderer: SDL_RenderGeometry failed: %s\n", SDL_GetError());
+            return;
+        }
+        RenderStats_RecordBatch(text->stats, tile->texture, batch->quad_count, glyph_pixels * batch->quad_count);
+    }
+}
+
+// 查找静态文本的排版结果，没有则排版并缓存
+static TextCacheEntry* get_layout(TextRenderer* text, const char* str, float scale) {
+    Uint32 bucket = hash_text(str, scale);
+    for (TextCacheEntry* entry = text->buckets[bucket]; entry; entry = entry->next) {
+        if (entry->scale == scale && strcmp(entry->text, str) == 0) {
+            entry->last_used = ++text->use_counter;
+            return entry;
+        }
+    }
+
+    // 缓存满时淘汰最久未用的一项
+    if (text->entry_count >= TEXT_CACHE_MAX_ENTRIES) {
+        TextCacheEntry** oldest = NULL;
+        for (int b = 0; b < TEXT_CACHE_BUCKETS; b++) {
+            for (TextCacheEntry** link = &text->buckets[b]; *link; link = &(*link)->next) {
+                if (!oldest || (*link)->last_used < (*oldest)->last_used) oldest = link;
+            }
+        }
+        TextCacheEntry* victim = *oldest;
+        *oldest = victim->next;
+        free_entry(text, victim);
+    }
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    int w = 0;
+    int h = 0;
+    int quads = layout(text, str, scale, 0.0f, 0.0f, white, true, &w, &h);
+    group_by_tile(text, quads);
+
+    TextCacheEntry* entry = (TextCacheEntry*)calloc(1, sizeof(TextCacheEntry));
+    if (!entry) return NULL;
+    entry->text = (char*)malloc(strlen(str) + 1);
+    entry->vertices = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * (quads > 0 ? quads : 1));
+    entry->batches = (TextBatch*)malloc(sizeof(TextBatch) * (text->batch_count > 0 ? text->batch_count : 1));
+    if (!entry->text || !entry->vertices || !entry->batches) {
+        fprintf(stderr, "TextRenderer: Failed to cache layout\n");
+        free(entry->text);
+        free(entry->vertices);
+        free(entry->batches);
+        free(entry);
+        return NULL;
+    }
+    strcpy(entry->text, str);
+    memcpy(entry->vertices, text->vertices, sizeof(SDL_Vertex) * 4 * quads);
+    memcpy(entry->batches, text->batches, sizeof(TextBatch) * text->batch_count);
+    entry->scale = scale;
+    entry->quad_count = quads;
+    entry->batch_count = text->batch_count;
+    entry->w = w;
+    entry->h = h;
+    entry->last_used = ++text->use_counter;
+    entry->next = text->buckets[bucket];
+    text->buckets[bucket] = entry;
+    text->entry_count++;
+    return entry;
+}
+
+// ========== 核心接口实现 ==========
+TextRenderer* TextRenderer_Create(AnimationManager* anim_manager, Animation* atlas, int first_char, int capacity, bool proportional) {
+    if (!anim_manager || !atlas || !atlas->frames || first_char < 0 || capacity <= 0) {
+        fprintf(stderr, "TextRenderer: Invalid params for Create\n");
+        return NULL;
+    }
+    if (atlas->index_sheet) {
+        fprintf(stderr, "TextRenderer: Glyph atlas '%s' must not be indexed\n", atlas->texture_key);
+        return NULL;
+    }
+
+    TextRenderer* text = (TextRenderer*)calloc(1, sizeof(TextRenderer));
+    if (!text) {
+        fprintf(stderr, "TextRenderer: Failed to allocate renderer\n");
+        return NULL;
+    }
+
+    text->atlas = atlas;
+    text->first_char = first_char;
+    text->glyph_count = atlas->total_frames;
+    text->cell_w = atlas->frames[0].rect.w;
+    text->cell_h = atlas->frames[0].rect.h;
+    text->capacity = capacity;
+    text->max_batches = atlas->tile_count < capacity ? atlas->tile_count : capacity;
+    text->anim_manager = anim_manager;
+    text->renderer = anim_manager->renderer;
+    text->stats = anim_manager->stats;
+
+    text->glyph_uv = (float*)malloc(sizeof(float) * 4 * text->glyph_count);
+    text->glyph_left = (int*)calloc(text->glyph_count, sizeof(int));
+    text->glyph_advance = (int*)malloc(sizeof(int) * text->glyph_count);
+    text->layout = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * (size_t)capacity);
+    text->quad_tile = (int*)malloc(sizeof(int) * (size_t)capacity);
+    text->vertices = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * (size_t)capacity);
+    text->indices = (int*)malloc(sizeof(int) * 6 * (size_t)capacity);
+    text->tile_quads = (int*)malloc(sizeof(int) * atlas->tile_count);
+    text->batches = (TextBatch*)malloc(sizeof(TextBatch) * text->max_batches);
+    if (!text->glyph_uv || !text->glyph_left || !text->glyph_advance || !text->layout || !text->quad_tile ||
+        !text->vertices || !text->indices || !text->tile_quads || !text->batches) {
+        fprintf(stderr, "TextRenderer: Failed to allocate buffers\n");
+        TextRenderer_Destroy(text);
+        return NULL;
+    }
+
+    // 字形在所在分块纹理中的坐标
+    for (int g = 0; g < text->glyph_count; g++) {
+        const SDL_Rect* src = &atlas->frames[g].src;
+        const SDL_Rect* area = &atlas->tiles[atlas->frames[g].tile].area;
+        text->glyph_uv[g * 4 + 0] = (float)src->x / area->w;
+        text->glyph_uv[g * 4 + 1] = (float)src->y / area->h;
+        text->glyph_uv[g * 4 + 2] = (float)(src->x + src->w) / area->w;
+        text->glyph_uv[g * 4 + 3] = (float)(src->y + src->h) / area->h;
+        text->glyph_advance[g] = text->cell_w;
+    }
+    if (proportional) {
+        if (atlas->alpha_masks) {
+            measure_glyphs(text);
+        } else {
+            fprintf(stderr, "TextRenderer: No alpha masks for '%s', using fixed width\n", atlas->texture_key);
+        }
+    }
+
+    for (int q = 0; q < capacity; q++) {
+        int v = q * 4;
+        int* idx = &text->indices[q * 6];
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+    }
+
+    // 使用渲染线程时由渲染线程按需上传；否则一次解码上传全部分块
+    if (!anim_manager->queue) {
+        for (int t = 0; t < atlas->tile_count; t++) text->tile_quads[t] = t;
+        if (!AnimationManager_UploadTiles(anim_manager, atlas, text->tile_quads, atlas->tile_count)) {
+            TextRenderer_Destroy(text);
+            return NULL;
+        }
+    }
+
+    printf("TextRenderer: Created ('%s', %d glyphs of %dx%d)\n", atlas->texture_key, text->glyph_count, text->cell_w, text->cell_h);
+    return text;
+}
+
+void TextRenderer_Measure(TextRenderer* text, const char* str, float scale, int* w, int* h) {
+    if (w) *w = 0;
+    if (h) *h = 0;
+    if (!text || !str) return;
+    SDL_Color white = { 255, 255, 255, 255 };
+    layout(text, str, scale, 0.0f, 0.0f, white, false, w, h);
+}
+
+void TextRenderer_Draw(TextRenderer* text, const char* str, float x, float y, float scale, SDL_Color color) {
+    if (!text || !str || scale <= 0.0f) return;
+    int quads = layout(text, str, scale, x, y, color, true, NULL, NULL);
+    group_by_tile(text, quads);
+    submit(text, text->batches, text->batch_count, scale);
+}
+
+void TextRenderer_DrawStatic(TextRenderer* text, const char* str, float x, float y, float scale, SDL_Color color) {
+    if (!text || !str || scale <= 0.0f) return;
+
+    TextCacheEntry* entry = get_layout(text, str, scale);
+    if (!entry) return;
+
+    // 缓存的顶点只平移和着色
+    int vertex_count = entry->quad_count * 4;
+    for (int i = 0; i < vertex_count; i++) {
+        text->vertices[i] = entry->vertices[i];
+        text->vertices[i].position.x += x;
+        text->vertices[i].position.y += y;
+        text->vertices[i].color = color;
+    }
+    submit(text, entry->batches, entry->batch_count, scale);
+}
+
+void TextRenderer_ClearCache(TextRenderer* text) {
+    if (!text) return;
+
+    for (int b = 0; b < TEXT_CACHE_BUCKETS; b++) {
+        TextCacheEntry* entry = text->buckets[b];
+        while (entry) {
+            TextCacheEntry* next = entry->next;
+            free_entry(text, entry);
+            entry = next;
+        }
+        text->buckets[b] = NULL;
+    }
+}
+
+void TextRenderer_Destroy(TextRenderer* text) {
+    if (!text) return;
+
+    TextRenderer_ClearCache(text);
+    free(text->glyph_uv);
+    free(text->glyph_left);
+    free(text->glyph_advance);
+    free(text->layout);
+    free(text->quad_tile);
+    free(text->vertices);
+    free(text->indices);
+    free(text->tile_quads);
+    free(text->batches);
+    free(text);
+
+    printf("TextRenderer: Destroyed\n");
+}
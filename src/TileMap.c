@@ -0,0 +1,256 @@
+#include "TileMap.h"
+#include "RenderQueue.h"
+
+// ========== 内部辅助函数 ==========
+// 重建区块顶点（地图像素坐标）：按图块所在分块计数排序，同一分块的四边形连续存放
+static bool build_chunk(TileMap* map, int cx, int cy) {
+    TileChunk* chunk = &map->chunks[cy * map->chunks_x + cx];
+    int tx0 = cx * TILEMAP_CHUNK_SIZE;
+    int ty0 = cy * TILEMAP_CHUNK_SIZE;
+    int tx1 = tx0 + TILEMAP_CHUNK_SIZE < map->width ? tx0 + TILEMAP_CHUNK_SIZE : map->width;
+    int ty1 = ty0 + TILEMAP_CHUNK_SIZE < map->height ? ty0 + TILEMAP_CHUNK_SIZE : map->height;
+
+    const Animation* tileset = map->tileset;
+    int* tile_quads = map->tile_quads;
+    memset(tile_quads, 0, sizeof(int) * tileset->tile_count);
+    int quads = 0;
+    for (int ty = ty0; ty < ty1; ty++) {
+        for (int tx = tx0; tx < tx1; tx++) {
+            Uint16 id = map->tiles[ty * map->width + tx];
+            if (id == TILEMAP_EMPTY) continue;
+            tile_quads[tileset->frames[id].tile]++;
+            quads++;
+        }
+    }
+    if (quads > chunk->quad_capacity) {
+        SDL_Vertex* vertices = (SDL_Vertex*)realloc(chunk->vertices, sizeof(SDL_Vertex) * 4 * quads);
+        if (!vertices) {
+            fprintf(stderr, "TileMap: Failed to allocate chunk vertices\n");
+            return false;
+        }
+        chunk->vertices = vertices;
+        chunk->quad_capacity = quads;
+    }
+
+    // 计数 -> 各分块起始位置，同时生成批次
+    chunk->batch_count = 0;
+    int offset = 0;
+    for (int t = 0; t < tileset->tile_count; t++) {
+        int count = tile_quads[t];
+        if (count == 0) continue;
+        chunk->batches[chunk->batch_count++] = (TileBatch){ t, offset, count };
+        tile_quads[t] = offset;
+        offset += count;
+    }
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    for (int ty = ty0; ty < ty1; ty++) {
+        for (int tx = tx0; tx < tx1; tx++) {
+            Uint16 id = map->tiles[ty * map->width + tx];
+            if (id == TILEMAP_EMPTY) continue;
+            SDL_Vertex* v = &chunk->vertices[tile_quads[tileset->frames[id].tile]++ * 4];
+            const float* uv = &map->tile_uv[id * 4];
+            float x0 = (float)(tx * map->tile_w);
+            float y0 = (float)(ty * map->tile_h);
+            float x1 = x0 + map->tile_w;
+            float y1 = y0 + map->tile_h;
+            v[0] = (SDL_Vertex){ { x0, y0 }, white, { uv[0], uv[1] } };
+            v[1] = (SDL_Vertex){ { x1, y0 }, white, { uv[2], uv[1] } };
+            v[2] = (SDL_Vertex){ { x0, y1 }, white, { uv[0], uv[3] } };
+            v[3] = (SDL_Vertex){ { x1, y1 }, white, { uv[2], uv[3] } };
+        }
+    }
+    chunk->quad_count = quads;
+    chunk->dirty = false;
+    return true;
+}
+
+// ========== 核心接口实现 ==========
+TileMap* TileMap_Create(AnimationManager* anim_manager, Animation* tileset, int width, int height) {
+    if (!anim_manager || !tileset || !tileset->frames || width <= 0 || height <= 0) {
+        fprintf(stderr, "TileMap: Invalid params for Create\n");
+        return NULL;
+    }
+    if (tileset->index_sheet || tileset->total_frames >= TILEMAP_EMPTY) {
+        fprintf(stderr, "TileMap: Tileset '%s' is indexed or has too many tiles\n", tileset->texture_key);
+        return NULL;
+    }
+    TileMap* map = (TileMap*)calloc(1, sizeof(TileMap));
+    if (!map) {
+        fprintf(stderr, "TileMap: Failed to allocate map\n");
+        return NULL;
+    }
+
+    map->width = width;
+    map->height = height;
+    map->tile_w = tileset->frames[0].rect.w;
+    map->tile_h = tileset->frames[0].rect.h;
+    map->chunks_x = (width + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    map->chunks_y = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    map->tileset = tileset;
+    map->anim_manager = anim_manager;
+    map->renderer = anim_manager->renderer;
+    map->stats = anim_manager->stats;
+
+    const int chunk_quads = TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE;
+    map->tiles = (Uint16*)malloc(sizeof(Uint16) * (size_t)width * height);
+    map->chunks = (TileChunk*)calloc((size_t)map->chunks_x * map->chunks_y, sizeof(TileChunk));
+    map->tile_uv = (float*)malloc(sizeof(float) * 4 * tileset->total_frames);
+    map->tile_quads = (int*)malloc(sizeof(int) * tileset->tile_count);
+    map->scratch = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * chunk_quads);
+    map->indices = (int*)malloc(sizeof(int) * 6 * chunk_quads);
+    if (!map->tiles || !map->chunks || !map->tile_uv || !map->tile_quads || !map->scratch || !map->indices) {
+        fprintf(stderr, "TileMap: Failed to allocate map arrays\n");
+        TileMap_Destroy(map);
+        return NULL;
+    }
+    memset(map->tiles, 0xFF, sizeof(Uint16) * (size_t)width * height);
+
+    // 一个区块最多用到 min(分块数, 格子数) 个分块
+    int max_batches = tileset->tile_count < chunk_quads ? tileset->tile_count : chunk_quads;
+    for (int c = 0; c < map->chunks_x * map->chunks_y; c++) {
+        map->chunks[c].batches = (TileBatch*)malloc(sizeof(TileBatch) * max_batches);
+        if (!map->chunks[c].batches) {
+            fprintf(stderr, "TileMap: Failed to allocate chunk batches\n");
+            TileMap_Destroy(map);
+            return NULL;
+        }
+    }
+
+    // 图块在所在分块纹理中的坐标
+    for (int i = 0; i < tileset->total_frames; i++) {
+        const SDL_Rect* src = &tileset->frames[i].src;
+        const SDL_Rect* area = &tileset->tiles[tileset->frames[i].tile].area;
+        map->tile_uv[i * 4 + 0] = (float)src->x / area->w;
+        map->tile_uv[i * 4 + 1] = (float)src->y / area->h;
+        map->tile_uv[i * 4 + 2] = (float)(src->x + src->w) / area->w;
+        map->tile_uv[i * 4 + 3] = (float)(src->y + src->h) / area->h;
+    }
+
+    for (int q = 0; q < chunk_quads; q++) {
+        int v = q * 4;
+        int* idx = &map->indices[q * 6];
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+    }
+
+    // 使用渲染线程时由渲染线程按需上传；否则一次解码上传全部分块
+    if (!anim_manager->queue) {
+        for (int t = 0; t < tileset->tile_count; t++) map->tile_quads[t] = t;
+        if (!AnimationManager_UploadTiles(anim_manager, tileset, map->tile_quads, tileset->tile_count)) {
+            TileMap_Destroy(map);
+            return NULL;
+        }
+    }
+
+    printf("TileMap: Created (%dx%d tiles, %dx%d chunks)\n", width, height, map->chunks_x, map->chunks_y);
+    return map;
+}
+
+void TileMap_SetTile(TileMap* map, int tx, int ty, Uint16 tile) {
+    if (!map || tx < 0 || ty < 0 || tx >= map->width || ty >= map->height) return;
+    if (tile != TILEMAP_EMPTY && tile >= map->tileset->total_frames) {
+        fprintf(stderr, "TileMap: Invalid tile %u (total: %d)\n", tile, map->tileset->total_frames);
+        return;
+    }
+
+    Uint16* cell = &map->tiles[ty * map->width + tx];
+    if (*cell == tile) return;
+    *cell = tile;
+    map->chunks[(ty / TILEMAP_CHUNK_SIZE) * map->chunks_x + tx / TILEMAP_CHUNK_SIZE].dirty = true;
+}
+
+Uint16 TileMap_GetTile(const TileMap* map, int tx, int ty) {
+    if (!map || tx < 0 || ty < 0 || tx >= map->width || ty >= map->height) return TILEMAP_EMPTY;
+    return map->tiles[ty * map->width + tx];
+}
+
+bool TileMap_Load(TileMap* map, const Uint16* tiles) {
+    if (!map || !tiles) return false;
+
+    size_t cells = (size_t)map->width * map->height;
+    for (size_t i = 0; i < cells; i++) {
+        if (tiles[i] != TILEMAP_EMPTY && tiles[i] >= map->tileset->total_frames) {
+            fprintf(stderr, "TileMap: Invalid tile %u at %zu (total: %d)\n", tiles[i], i, map->tileset->total_frames);
+            return false;
+        }
+    }
+    memcpy(map->tiles, tiles, sizeof(Uint16) * cells);
+    for (int c = 0; c < map->chunks_x * map->chunks_y; c++) {
+        map->chunks[c].dirty = true;
+    }
+    return true;
+}
+
+void TileMap_Draw(TileMap* map, const SDL_Rect* view) {
+    if (!map || !view || view->w <= 0 || view->h <= 0) return;
+
+    // 使用渲染线程时分块纹理归渲染线程所有，这里不读取
+    struct RenderQueue* queue = map->anim_manager->queue;
+
+    // 与视口相交的区块范围
+    int chunk_w = TILEMAP_CHUNK_SIZE * map->tile_w;
+    int chunk_h = TILEMAP_CHUNK_SIZE * map->tile_h;
+    int cx0 = view->x > 0 ? view->x / chunk_w : 0;
+    int cy0 = view->y > 0 ? view->y / chunk_h : 0;
+    int cx1 = view->x + view->w > 0 ? (view->x + view->w - 1) / chunk_w : -1;
+    int cy1 = view->y + view->h > 0 ? (view->y + view->h - 1) / chunk_h : -1;
+    if (cx1 >= map->chunks_x) cx1 = map->chunks_x - 1;
+    if (cy1 >= map->chunks_y) cy1 = map->chunks_y - 1;
+
+    const float ox = (float)view->x;
+    const float oy = (float)view->y;
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            TileChunk* chunk = &map->chunks[cy * map->chunks_x + cx];
+            if (chunk->dirty && !build_chunk(map, cx, cy)) continue;
+            if (chunk->quad_count == 0) continue;
+
+            // 缓存的顶点只平移到屏幕坐标
+            int vertex_count = chunk->quad_count * 4;
+            for (int i = 0; i < vertex_count; i++) {
+                map->scratch[i] = chunk->vertices[i];
+                map->scratch[i].position.x -= ox;
+                map->scratch[i].position.y -= oy;
+            }
+
+            // 每个用到的分块一次提交
+            for (int b = 0; b < chunk->batch_count; b++) {
+                const TileBatch* batch = &chunk->batches[b];
+                AnimationTile* tile = &map->tileset->tiles[batch->tile];
+                SDL_Vertex* vertices = map->scratch + batch->first_quad * 4;
+                if (queue) {
+                    RenderQueue_PushGeometry(queue, map->tileset, batch->tile, vertices, batch->quad_count);
+                    RenderStats_RecordBatch(map->stats, tile, batch->quad_count, (Uint64)batch->quad_count * map->tile_w * map->tile_h);
+                    continue;
+                }
+                if (!tile->texture) continue;
+                if (SDL_RenderGeometry(map->renderer, tile->texture, vertices, batch->quad_count * 4, map->indices, batch->quad_count * 6) != 0) {
+                    fprintf(stderr, "TileMap: SDL_RenderGeometry failed: %s\n", SDL_GetError());
+                    return;
+                }
+                RenderStats_RecordBatch(map->stats, tile->texture, batch->quad_count, (Uint64)batch->quad_count * map->tile_w * map->tile_h);
+            }
+        }
+    }
+}
+
+void TileMap_Destroy(TileMap* map) {
+    if (!map) return;
+
+    if (map->chunks) {
+        for (int c = 0; c < map->chunks_x * map->chunks_y; c++) {
+            free(map->chunks[c].vertices);
+            free(map->chunks[c].batches);
+        }
+    }
+    free(map->chunks);
+    free(map->tiles);
+    free(map->tile_uv);
+    free(map->tile_quads);
+    free(map->scratch);
+    free(map->indices);
+    free(map);
+
+    printf("TileMap: Destroyed\n");
+}
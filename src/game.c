@@ -1,10 +1,12 @@
 #include "game.h"
 
+static SpriteEntity s_player = SPRITE_ENTITY_INVALID;
 
 void init()
 {
     
-    SDL_Texture* tex_player = ImageManager_LoadTexture(commons->imageManager, "player_sprites", "./assets/image/player/player1.png");
+    // 精灵图共 20 行但只用到少数几行：只登记不整图上传，播放时按行分块上传
+    ImageManager_RegisterSheet(commons->imageManager, "player_sprites", "./assets/image/player/player1.png");
     // 加载动画（4行8列分割精灵图）
     Animation* player_anim = AnimationManager_LoadAnimation(
         commons->g_anim_manager,
@@ -45,29 +47,26 @@ void init()
         false              // 不反向
     );
 
-    // 播放 idle 动画
-    AnimationManager_Play(commons->g_anim_manager, "player", "attack1");
+    // 创建玩家实体（屏幕中心，缩放10倍，无旋转/翻转）
+    s_player = SpriteStore_CreateEntity(commons->g_sprite_store, player_anim, 400, 300);
+    SpriteStore_SetTransform(commons->g_sprite_store, s_player, 10.0f, 0.0f, SDL_FLIP_NONE);
+    // 播放 attack1 动画
+    SpriteStore_Play(commons->g_sprite_store, s_player, "attack1");
     // 设置播放速度（1.5倍速）
-    AnimationManager_SetSpeed(commons->g_anim_manager, "player", 1.5f);
+    SpriteStore_SetSpeed(commons->g_sprite_store, s_player, 1.5f);
 }
 void update(float dt)
 {
+    // 模拟前批量执行外部控制命令：第 N 帧期间到达的命令在第 N+1 帧的模拟和绘制中生效
+    ControlSocket_Service(commons->g_control, commons->imageManager, commons->g_sprite_store, RenderStats_GetInstance());
     AnimationManager_Update(commons->g_anim_manager, dt);
+    SpriteStore_Update(commons->g_sprite_store, dt);
 }
 
 void draw()
 {
-
-    // 绘制动画（屏幕中心，缩放2倍，无旋转/翻转）
-    AnimationManager_Draw(
-        commons->g_anim_manager,
-        "player",
-        400, 300,    // 绘制位置（中心）
-        0, 0,        // 自动尺寸
-        10.0f,        // 缩放2倍
-        0.0f,        // 无旋转
-        SDL_FLIP_NONE // 无翻转
-    );
+    // 按层绘制全部精灵实体
+    SpriteStore_DrawAll(commons->g_sprite_store);
 
 }
 
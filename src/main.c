@@ -2,7 +2,13 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "game.h"
+#include "FrameRecorder.h"
+#include "RenderStats.h"
+#include "RenderQueue.h"
+#include "PaletteManager.h"
+#include "TextRenderer.h"
 
 // Windows系统API
 #if defined(_WIN32) || defined(WIN32)
@@ -11,6 +17,7 @@
 #endif
 
 #define WINDOW_TITLE  "SDL Fullscreen Transparent Window (Global Renderer)"
+#define SPRITE_STORE_CAPACITY 4096
 
 
 // ========== 1. 全局变量声明（核心） ==========
@@ -19,6 +26,8 @@ SDL_Window* g_window = NULL;     // 可选：窗口也声明为全局，方便
 CommonS *commons;
 int WINDOW_WIDTH = 0;
 int WINDOW_HEIGHT = 0;
+SDL_Surface* g_headless_surface = NULL; // 回放模式下软件渲染器的目标表面
+RenderQueue* g_render_queue = NULL;     // 渲染线程（--render-thread 时启用）
 
 // 错误处理宏
 #define SDL_CHECK_ERROR(func) \
@@ -60,14 +69,88 @@ int WINDOW_HEIGHT = 0;
     }
 #endif
 
+// 处理单个事件（实时输入与回放输入共用）
+static void handle_event(const SDL_Event* event, bool* isRunning) {
+    if (event->type == SDL_QUIT || (event->type == SDL_KEYDOWN && (event->key.keysym.sym == SDLK_ESCAPE || event->key.keysym.sym == SDLK_q))) {
+        *isRunning = false;
+    }
+}
+
+static void print_usage(const char* exe) {
+    fprintf(stderr, "Usage: %s [--record <log>] [--replay <log> [--realtime]] [--control <socket>] [--render-thread] [--font <sheet>]\n", exe);
+}
+
+// 调试信息：模式标签不变走排版缓存，帧率和统计每帧重新排版
+static void draw_overlay(TextRenderer* text, float dt, const char* mode) {
+    static float fps = 0.0f;
+    if (dt > 0.0f) fps = fps > 0.0f ? fps * 0.95f + (1.0f / dt) * 0.05f : 1.0f / dt;
+
+    const RenderFrameStats* last = RenderStats_GetLastFrame(RenderStats_GetInstance());
+    char line[128];
+    snprintf(line, sizeof(line), "FPS %.0f\ndraw calls %u  sprites %u  overdraw %.2f",
+             fps, last->draw_calls, last->sprites, last->overdraw);
+
+    SDL_Color label = { 255, 220, 120, 255 };
+    SDL_Color value = { 255, 255, 255, 255 };
+    TextRenderer_DrawStatic(text, mode, 8.0f, 8.0f, 2.0f, label);
+    TextRenderer_Draw(text, line, 8.0f, 8.0f + text->cell_h * 2.0f, 2.0f, value);
+}
+
 
 int main(int argc, char* argv[]) {
-    // 初始化SDL
+    // 解析命令行：--record 录制帧日志，--replay 无窗口回放（默认全速，--realtime 按录制速度）
+    // --control 开启本地控制 socket，--render-thread 由独立线程执行绘制（回放模式下忽略）
+    // --font 指定位图字体字形表（16 列 6 行，ASCII 32~127），显示帧率和渲染统计
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    const char* control_path = NULL;
+    const char* font_path = NULL;
+    bool replay_realtime = false;
+    bool render_thread = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--control") == 0 && i + 1 < argc) {
+            control_path = argv[++i];
+        } else if (strcmp(argv[i], "--font") == 0 && i + 1 < argc) {
+            font_path = argv[++i];
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            replay_realtime = true;
+        } else if (strcmp(argv[i], "--render-thread") == 0) {
+            render_thread = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    // 录制与回放互斥；--realtime 只对回放有意义
+    if ((record_path && replay_path) || (replay_realtime && !replay_path)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    bool headless = replay_path != NULL;
+
+    // 回放模式不需要真实窗口，使用 dummy 视频驱动
+    if (headless) SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+    // 初始化SDL（在打开日志之前，失败时没有需要关闭的文件）
     SDL_CHECK_ERROR(SDL_Init(SDL_INIT_VIDEO));
 
-    // 获取桌面分辨率
+    FrameRecorder* recorder = NULL;
+    if (record_path || replay_path) {
+        recorder = FrameRecorder_Open(headless ? replay_path : record_path,
+                                      headless ? FRAME_RECORDER_REPLAY : FRAME_RECORDER_RECORD);
+        if (!recorder) {
+            SDL_Quit();
+            return 1;
+        }
+    }
+
+    // 获取桌面分辨率（回放模式固定 1920x1080，保证不同机器结果可比）
     SDL_DisplayMode dm;
-    if (SDL_GetCurrentDisplayMode(0, &dm) == 0) {
+    if (!headless && SDL_GetCurrentDisplayMode(0, &dm) == 0) {
         WINDOW_WIDTH = dm.w;
         WINDOW_HEIGHT = dm.h;
     } else {
@@ -75,45 +158,65 @@ int main(int argc, char* argv[]) {
         WINDOW_HEIGHT = 1080;
     }
 
-    // 创建全屏无边框窗口（赋值给全局窗口）
-    g_window = SDL_CreateWindow(
-        WINDOW_TITLE,
-        SDL_WINDOWPOS_CENTERED,
-        SDL_WINDOWPOS_CENTERED,
-        WINDOW_WIDTH, WINDOW_HEIGHT,
-        SDL_WINDOW_FULLSCREEN_DESKTOP | SDL_WINDOW_BORDERLESS | SDL_WINDOW_SHOWN
-    );
-    if (!g_window) {
-        fprintf(stderr, "SDL Error: %s (in SDL_CreateWindow)\n", SDL_GetError());
-        SDL_Quit();
-        return 1;
-    }
-
-    // ========== 3. 初始化全局渲染器（核心） ==========
-    g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!g_renderer) g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_SOFTWARE);
-    if (!g_renderer) {
-        fprintf(stderr, "SDL Error: %s (in SDL_CreateRenderer)\n", SDL_GetError());
-        SDL_DestroyWindow(g_window);
-        SDL_Quit();
-        return 1;
-    }
+    if (headless) {
+        // 回放模式：软件渲染到内存表面，不创建窗口
+        g_headless_surface = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (g_headless_surface) g_renderer = SDL_CreateSoftwareRenderer(g_headless_surface);
+        if (!g_renderer) {
+            fprintf(stderr, "SDL Error: %s (in SDL_CreateSoftwareRenderer)\n", SDL_GetError());
+            if (g_headless_surface) SDL_FreeSurface(g_headless_surface);
+            FrameRecorder_Close(recorder);
+            SDL_Quit();
+            return 1;
+        }
+    } else {
+        // 创建全屏无边框窗口（赋值给全局窗口）
+        g_window = SDL_CreateWindow(
+            WINDOW_TITLE,
+            SDL_WINDOWPOS_CENTERED,
+            SDL_WINDOWPOS_CENTERED,
+            WINDOW_WIDTH, WINDOW_HEIGHT,
+            SDL_WINDOW_FULLSCREEN_DESKTOP | SDL_WINDOW_BORDERLESS | SDL_WINDOW_SHOWN
+        );
+        if (!g_window) {
+            fprintf(stderr, "SDL Error: %s (in SDL_CreateWindow)\n", SDL_GetError());
+            FrameRecorder_Close(recorder);
+            SDL_Quit();
+            return 1;
+        }
 
-    // Windows API设置置顶+透明
-    #if defined(_WIN32) || defined(WIN32)
-        SDL_Delay(100);
-        HWND sdl_hwnd = GetSDLWindowHandle();
-        if (sdl_hwnd) {
-            SetWindowAlwaysOnTopWin32(sdl_hwnd, true);
-            RemoveWindowBorder(sdl_hwnd);
-            SetWindowLongPtr(sdl_hwnd, GWL_EXSTYLE, GetWindowLongPtr(sdl_hwnd, GWL_EXSTYLE) | WS_EX_LAYERED);
-            SetLayeredWindowAttributes(sdl_hwnd, RGB(0,0,0), 255, LWA_COLORKEY | LWA_ALPHA);
+        // ========== 3. 初始化全局渲染器（核心） ==========
+        if (render_thread) {
+            // 渲染器由渲染线程创建并独占，主线程只录制绘制命令；g_renderer 保持 NULL，主线程误用会直接报错
+            g_render_queue = RenderQueue_Create(g_window);
+        } else {
+            g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+            if (!g_renderer) g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_SOFTWARE);
+        }
+        if (!g_renderer && !g_render_queue) {
+            fprintf(stderr, "SDL Error: %s (in SDL_CreateRenderer)\n", SDL_GetError());
+            SDL_DestroyWindow(g_window);
+            FrameRecorder_Close(recorder);
+            SDL_Quit();
+            return 1;
         }
-    #endif
 
-    // 启用混合模式
-    SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetWindowAlwaysOnTop(g_window, SDL_TRUE);
+        // Windows API设置置顶+透明
+        #if defined(_WIN32) || defined(WIN32)
+            SDL_Delay(100);
+            HWND sdl_hwnd = GetSDLWindowHandle();
+            if (sdl_hwnd) {
+                SetWindowAlwaysOnTopWin32(sdl_hwnd, true);
+                RemoveWindowBorder(sdl_hwnd);
+                SetWindowLongPtr(sdl_hwnd, GWL_EXSTYLE, GetWindowLongPtr(sdl_hwnd, GWL_EXSTYLE) | WS_EX_LAYERED);
+                SetLayeredWindowAttributes(sdl_hwnd, RGB(0,0,0), 255, LWA_COLORKEY | LWA_ALPHA);
+            }
+        #endif
+    }
+
+    // 启用混合模式（渲染线程已自行设置）
+    if (!g_render_queue) SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_BLEND);
+    if (g_window) SDL_SetWindowAlwaysOnTop(g_window, SDL_TRUE);
 
     // 计时变量
     bool isRunning = true;
@@ -128,41 +231,109 @@ int main(int argc, char* argv[]) {
     commons->imageManager = ImageManager_GetInstance(g_renderer);
     // 初始化 AnimationManager
     commons->g_anim_manager = AnimationManager_Create(commons->imageManager, g_renderer);
+    // 回放模式为软件渲染：索引精灵图查表直接写入目标表面
+    if (headless) PaletteManager_SetTarget(commons->g_anim_manager->palettes, g_headless_surface);
+    if (g_render_queue) {
+        RenderQueue_Attach(g_render_queue, commons->g_anim_manager);
+        // 主线程不查询渲染器，统计用窗口尺寸
+        RenderStats_GetInstance()->screen_w = WINDOW_WIDTH;
+        RenderStats_GetInstance()->screen_h = WINDOW_HEIGHT;
+    }
+    // 初始化精灵实体存储
+    commons->g_sprite_store = SpriteStore_Create(commons->g_anim_manager, SPRITE_STORE_CAPACITY);
+    // 回放模式下不监听 socket，按日志在同一帧重放录制时执行的命令，保证结果可复现
+    if (headless) {
+        commons->g_control = ControlSocket_CreateReplay(recorder);
+    } else {
+        commons->g_control = control_path ? ControlSocket_Create(control_path) : NULL;
+        ControlSocket_AttachRecorder(commons->g_control, recorder);
+    }
+    // 调试文字（使用渲染线程时字形表由渲染线程上传）
+    TextRenderer* overlay = NULL;
+    const char* overlay_mode = headless ? "replay" : (g_render_queue ? "render thread" : "direct");
+    if (font_path) {
+        bool loaded = g_render_queue
+            ? ImageManager_RegisterSheet(commons->imageManager, "debug_font", font_path)
+            : ImageManager_LoadTexture(commons->imageManager, "debug_font", font_path) != NULL;
+        Animation* font = loaded ? AnimationManager_LoadAnimation(commons->g_anim_manager, "debug_font", "debug_font", 6, 16) : NULL;
+        overlay = font ? TextRenderer_Create(commons->g_anim_manager, font, 32, 256, true) : NULL;
+    }
 
 
     init();
 
+    Uint64 perf_freq = SDL_GetPerformanceFrequency();
+
     // 主循环
     while (isRunning) {
-        // 事件处理
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT || (event.type == SDL_KEYDOWN && (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_q))) {
-                isRunning = false;
+        Uint64 frame_start = SDL_GetPerformanceCounter();
+
+        if (headless) {
+            // 回放：dt 和事件均来自日志
+            const SDL_Event* events = NULL;
+            int event_count = 0;
+            if (!FrameRecorder_ReadFrame(recorder, &dt_float, &events, &event_count)) break;
+            for (int i = 0; i < event_count; i++) {
+                handle_event(&events[i], &isRunning);
+            }
+        } else {
+            // 事件处理
+            while (SDL_PollEvent(&event)) {
+                FrameRecorder_PushEvent(recorder, &event);
+                handle_event(&event, &isRunning);
             }
-        }
 
-        // 计算dt
-        Uint32 current_ticks = SDL_GetTicks();
-        dt_float = (current_ticks - last_ticks) / 1000.0f;
-        last_ticks = current_ticks;
+            // 计算dt
+            Uint32 current_ticks = SDL_GetTicks();
+            dt_float = (current_ticks - last_ticks) / 1000.0f;
+            last_ticks = current_ticks;
+        }
 
         update(dt_float);
-         // 清空整个渲染器（删除上一帧所有绘制内容）
-        if (SDL_RenderClear(g_renderer) != 0) {
-            fprintf(stderr, "SDL_RenderClear failed: %s\n", SDL_GetError());
-        }
+        if (g_render_queue) {
+            // 录制本帧命令并提交，渲染线程负责清屏、绘制和 Present
+            RenderStats_BeginFrame(RenderStats_GetInstance(), NULL);
+            draw();
+            if (overlay) draw_overlay(overlay, dt_float, overlay_mode);
+            RenderQueue_Submit(g_render_queue);
+        } else {
+             // 清空整个渲染器（删除上一帧所有绘制内容）
+            if (SDL_RenderClear(g_renderer) != 0) {
+                fprintf(stderr, "SDL_RenderClear failed: %s\n", SDL_GetError());
+            }
+            RenderStats_BeginFrame(RenderStats_GetInstance(), g_renderer);
+
+            draw(); // 自定义绘制（也可直接用g_renderer）
+            if (overlay) draw_overlay(overlay, dt_float, overlay_mode);
 
-        draw(); // 自定义绘制（也可直接用g_renderer）
+            // 更新屏幕
+            SDL_RenderPresent(g_renderer);
+            PaletteManager_EndFrame(commons->g_anim_manager->palettes);
+        }
+        RenderStats_EndFrame(RenderStats_GetInstance());
 
-        // 更新屏幕
-        SDL_RenderPresent(g_renderer);
+        if (headless) {
+            double frame_ms = (SDL_GetPerformanceCounter() - frame_start) * 1000.0 / perf_freq;
+            FrameRecorder_ReportFrame(recorder, dt_float, frame_ms);
+            // 按录制速度回放时补足剩余时间
+            if (replay_realtime && dt_float * 1000.0 > frame_ms) {
+                SDL_Delay((Uint32)(dt_float * 1000.0 - frame_ms));
+            }
+        } else if (recorder) {
+            FrameRecorder_WriteFrame(recorder, dt_float);
+        }
     }
 
     destroyed();
+    TextRenderer_Destroy(overlay);
+    ControlSocket_Destroy(commons->g_control);
+    FrameRecorder_Close(recorder);
 
     // ========== 5. 释放全局资源（核心） ==========
+    if (g_render_queue) RenderQueue_Destroy(g_render_queue); // 渲染线程退出时释放纹理并销毁渲染器
     if (g_renderer) SDL_DestroyRenderer(g_renderer); // 释放全局渲染器
     if (g_window) SDL_DestroyWindow(g_window);       // 释放全局窗口
+    if (g_headless_surface) SDL_FreeSurface(g_headless_surface);
     SDL_Quit();
 
     return 0;